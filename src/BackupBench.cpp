@@ -0,0 +1,195 @@
+#include "BackupBench.h"
+
+#include "bn_common.h"
+
+#include "CartMonitor.h"
+#include "CycleCounter.h"
+
+BN_DATA_EWRAM_BSS static unsigned char original[BackupMemory::MAX_SECTOR_SIZE];
+BN_DATA_EWRAM_BSS static unsigned char pattern[BackupMemory::MAX_SECTOR_SIZE];
+BN_DATA_EWRAM_BSS static unsigned char readBack[BackupMemory::MAX_SECTOR_SIZE];
+
+static bool same(const unsigned char *a, const unsigned char *b, int size) {
+    for (int i = 0; i < size; i++) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+static unsigned perSecond(int bytes, unsigned long long cycles) {
+    if (!cycles) return 0;
+    return static_cast<unsigned>(bytes * static_cast<unsigned long long>(CycleCounter::CYCLES_PER_SECOND) / cycles);
+}
+
+static unsigned microseconds(unsigned long long cycles) {
+    return static_cast<unsigned>(cycles * 1000000 / CycleCounter::CYCLES_PER_SECOND);
+}
+
+void BackupBench::start(BackupMemory::Type value) {
+    *this = BackupBench();
+    type = value;
+    removalsAtStart = CartMonitor::removals();
+    CycleCounter::ensureRunning();
+    current = BackupMemory::writable(type) ? Phase::Reading : Phase::Done;
+}
+
+void BackupBench::run(unsigned budgetCycles) {
+    unsigned begin = CycleCounter::now();
+    while ((current == Phase::Reading || current == Phase::Writing) && CycleCounter::now() - begin < budgetCycles) {
+        // Whatever is in the slot now may not be the cart we backed up
+        if (CartMonitor::removals() != removalsAtStart) {
+            fail("Cart pulled mid-test, check its save");
+            return;
+        }
+        if (current == Phase::Reading) {
+            readStep();
+        } else {
+            writeStep();
+        }
+    }
+}
+
+void BackupBench::abort(const char *reason) {
+    if (current == Phase::Reading || current == Phase::Writing) fail(reason);
+}
+
+void BackupBench::fail(const char *reason) {
+    current = Phase::Failed;
+    failureReason = reason;
+}
+
+void BackupBench::readStep() {
+    int size = BackupMemory::sectorSize(type);
+    unsigned start = CycleCounter::now();
+    BackupMemory::readSector(type, sector, readBack);
+    readCycles += CycleCounter::now() - start;
+    bytesRead += size;
+    if (++sector < sectorTotal()) return;
+    sector = 0;
+    current = Phase::Writing;
+}
+
+void BackupBench::writeStep() {
+    int size = BackupMemory::sectorSize(type);
+    const unsigned char *source = restoring ? original : pattern;
+    switch (step) {
+        case Step::Backup:
+            BackupMemory::readSector(type, sector, original);
+            for (int i = 0; i < size; i++) {
+                pattern[i] = static_cast<unsigned char>((i * 7 + sector * 13) ^ (sector & 1 ? 0xAA : 0x55));
+            }
+            restoring = false;
+            step = Step::Erase;
+            break;
+
+        case Step::Erase:
+            stepStart = CycleCounter::now();
+            BackupMemory::startErase(type, sector);
+            step = Step::WaitErase;
+            break;
+
+        case Step::WaitErase: {
+            // Wall time since the command, so an erase that spans frames reads up to a frame long
+            unsigned elapsed = CycleCounter::now() - stepStart;
+            if (BackupMemory::eraseDone(type, sector)) {
+                if (type == BackupMemory::Type::Flash64 || type == BackupMemory::Type::Flash128) {
+                    eraseCycles += elapsed;
+                    erases++;
+                }
+                storeCycles = elapsed;
+                offset = 0;
+                step = Step::Program;
+            } else if (elapsed > CycleCounter::CYCLES_PER_SECOND / 2) {
+                stored(false);
+            }
+            break;
+        }
+
+        case Step::Program:
+            chunkStart = CycleCounter::now();
+            if (!BackupMemory::startChunk(type, sector, offset, source + offset)) {
+                stored(false);
+                break;
+            }
+            step = Step::WaitProgram;
+            break;
+
+        case Step::WaitProgram: {
+            // Wall time again, a page still programming when the budget runs out is picked up next frame
+            unsigned elapsed = CycleCounter::now() - chunkStart;
+            if (!BackupMemory::chunkDone(type, sector, offset, source + offset)) {
+                if (elapsed > CycleCounter::CYCLES_PER_SECOND / 50) stored(false);
+                break;
+            }
+            writeCycles += elapsed;
+            storeCycles += elapsed;
+            offset += BackupMemory::chunkSize(type);
+            if (offset < size) {
+                step = Step::Program;
+                break;
+            }
+            bytesWritten += size;
+            step = Step::Verify;
+            break;
+        }
+
+        case Step::Verify:
+            stored(true);
+            break;
+    }
+}
+
+void BackupBench::stored(bool written) {
+    int size = BackupMemory::sectorSize(type);
+    if (restoring) {
+        if (!written) {
+            fail("Restore timed out, save damaged");
+            return;
+        }
+        BackupMemory::readSector(type, sector, readBack);
+        if (!same(original, readBack, size)) {
+            fail("Restore did not verify, save damaged");
+            return;
+        }
+        step = Step::Backup;
+        if (++sector == sectorTotal()) current = Phase::Done;
+        return;
+    }
+
+    if (written) {
+        BackupMemory::readSector(type, sector, readBack);
+        sectorCycles += storeCycles;
+        if (!minSectorCycles || storeCycles < minSectorCycles) minSectorCycles = storeCycles;
+        if (storeCycles > maxSectorCycles) maxSectorCycles = storeCycles;
+    }
+    if (!written || !same(pattern, readBack, size)) badSectors++;
+
+    // Whatever happened above, the original has to go back
+    restoring = true;
+    step = Step::Erase;
+}
+
+unsigned BackupBench::readBytesPerSecond() const {
+    return perSecond(bytesRead, readCycles);
+}
+
+unsigned BackupBench::writeBytesPerSecond() const {
+    return perSecond(bytesWritten, writeCycles);
+}
+
+unsigned BackupBench::eraseMicroseconds() const {
+    return erases ? microseconds(eraseCycles / erases) : 0;
+}
+
+unsigned BackupBench::minSectorMicroseconds() const {
+    return microseconds(minSectorCycles);
+}
+
+unsigned BackupBench::avgSectorMicroseconds() const {
+    int tested = sector ? sector : 1;
+    return microseconds(sectorCycles / tested);
+}
+
+unsigned BackupBench::maxSectorMicroseconds() const {
+    return microseconds(maxSectorCycles);
+}
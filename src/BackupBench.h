@@ -0,0 +1,109 @@
+#pragma once
+
+#include "BackupMemory.h"
+
+/**
+ * Throughput and health check of the cart's save chip.
+ * Reads the whole chip once, then for every sector: backs it up, writes and verifies a test pattern,
+ * and puts the original back, verifying that too. Runs a frame budget at a time: erases and chunk writes are polled
+ * rather than waited on and sectors are programmed a chunk at a time, so no single step blows the budget.
+ * Stops touching the bus the moment the cart is pulled.
+ */
+class BackupBench {
+public:
+    enum class Phase : unsigned char {
+        Idle, Reading, Writing, Done, Failed
+    };
+
+    void start(BackupMemory::Type value);
+
+    /**
+     * Works through steps until the budget is spent, a sector may be left mid-write until the next call
+     */
+    void run(unsigned budgetCycles);
+
+    /**
+     * Gives up wherever it is, e.g. when the cart is swapped
+     */
+    void abort(const char *reason);
+
+    [[nodiscard]] Phase phase() const {
+        return current;
+    }
+
+    [[nodiscard]] const char *failure() const {
+        return failureReason;
+    }
+
+    [[nodiscard]] int sectorsDone() const {
+        return sector;
+    }
+
+    [[nodiscard]] int sectorTotal() const {
+        return BackupMemory::sectorCount(type);
+    }
+
+    [[nodiscard]] unsigned readBytesPerSecond() const;
+
+    [[nodiscard]] unsigned writeBytesPerSecond() const;
+
+    /**
+     * Average sector erase, zero for chips written in place
+     */
+    [[nodiscard]] unsigned eraseMicroseconds() const;
+
+    [[nodiscard]] unsigned minSectorMicroseconds() const;
+
+    [[nodiscard]] unsigned avgSectorMicroseconds() const;
+
+    [[nodiscard]] unsigned maxSectorMicroseconds() const;
+
+    /**
+     * Sectors whose test pattern did not read back intact, the original was still restored
+     */
+    [[nodiscard]] int patternErrors() const {
+        return badSectors;
+    }
+
+private:
+    // Where the current sector is in its pattern write, verify and restore
+    enum class Step : unsigned char {
+        Backup, Erase, WaitErase, Program, WaitProgram, Verify
+    };
+
+    BackupMemory::Type type = BackupMemory::Type::None;
+    Phase current = Phase::Idle;
+    Step step = Step::Backup;
+    const char *failureReason = "";
+    unsigned removalsAtStart = 0;
+    int sector = 0;
+    int badSectors = 0;
+    // Writing the original back rather than the pattern
+    bool restoring = false;
+    int offset = 0;
+    unsigned stepStart = 0;
+    unsigned chunkStart = 0;
+    unsigned storeCycles = 0;
+
+    unsigned long long readCycles = 0;
+    unsigned long long writeCycles = 0;
+    unsigned long long eraseCycles = 0;
+    int erases = 0;
+    int bytesRead = 0;
+    int bytesWritten = 0;
+
+    unsigned long long sectorCycles = 0;
+    unsigned minSectorCycles = 0;
+    unsigned maxSectorCycles = 0;
+
+    void readStep();
+
+    void writeStep();
+
+    /**
+     * Pattern or original write finished, well or not
+     */
+    void stored(bool written);
+
+    void fail(const char *reason);
+};
@@ -0,0 +1,353 @@
+#include "BackupMemory.h"
+
+#include "tonc.h"
+
+#include "CycleCounter.h"
+
+#define SAVE_BASE ((volatile unsigned char *)0x0E000000)
+// Mirrored across the top of the region, this address works whatever the ROM size
+#define EEPROM_PORT ((volatile unsigned short *)0x0DFFFF00)
+#define ROM_BASE ((volatile unsigned *)0x08000000)
+#define ROM_BYTES ((volatile unsigned char *)0x08000000)
+#define ROM_LIMIT (32 * 1024 * 1024)
+
+#define SRAM_SIZE (32 * 1024)
+#define FLASH_SECTOR_SIZE 4096
+#define FLASH_BANK_SECTORS 16
+#define ATMEL_PAGE_SIZE 128
+#define EEPROM_BLOCK_SIZE 8
+
+// First four characters of the save library IDs, as a little endian word
+#define ID_SRAM 0x4D415253
+#define ID_FLASH 0x53414C46
+#define ID_EEPROM 0x52504545
+
+#define ID_ATMEL 0x1F3D
+#define ID_MACRONIX_128K 0xC209
+#define ID_SANYO_128K 0x6213
+
+// Words of ROM looked at per detectStep()
+#define WORDS_PER_STEP 8192
+
+namespace BackupMemory {
+    static int scanWord = 0;
+    static Type type = Type::None;
+    static unsigned short chipId = 0;
+
+    static bool romMatches(int offset, const char *text) {
+        for (; *text; ++text, ++offset) {
+            if (ROM_BYTES[offset] != static_cast<unsigned char>(*text)) return false;
+        }
+        return true;
+    }
+
+    static bool pastRomEnd(int word) {
+        // Nothing drives the bus past the end, it floats to the low halves of the address
+        unsigned low = (word * 2) & 0xFFFF;
+        return ROM_BASE[word] == (low | ((low + 1) & 0xFFFF) << 16);
+    }
+
+    static bool waitUntil(volatile unsigned char *address, unsigned char value, unsigned timeoutCycles) {
+        unsigned start = CycleCounter::now();
+        while (*address != value) {
+            if (CycleCounter::now() - start > timeoutCycles) return false;
+        }
+        return true;
+    }
+
+    static void flashCommand(unsigned char command) {
+        SAVE_BASE[0x5555] = 0xAA;
+        SAVE_BASE[0x2AAA] = 0x55;
+        SAVE_BASE[0x5555] = command;
+    }
+
+    static unsigned short readFlashId() {
+        flashCommand(0x90);
+        // Some chips need a moment to switch into ID mode
+        unsigned start = CycleCounter::now();
+        while (CycleCounter::now() - start < CycleCounter::CYCLES_PER_SECOND / 1000) {}
+        unsigned short id = SAVE_BASE[0] << 8 | SAVE_BASE[1];
+        flashCommand(0xF0);
+        // Sanyo parts only leave ID mode on a bare reset
+        SAVE_BASE[0] = 0xF0;
+        return id;
+    }
+
+    static volatile unsigned char *flashSector(Type kind, int sector) {
+        if (kind == Type::Flash128) {
+            flashCommand(0xB0);
+            SAVE_BASE[0] = sector / FLASH_BANK_SECTORS;
+        }
+        return SAVE_BASE + (sector % FLASH_BANK_SECTORS) * FLASH_SECTOR_SIZE;
+    }
+
+    static void eepromTransfer(const volatile void *source, volatile void *destination, int halfwords) {
+        REG_DMA3SAD = reinterpret_cast<unsigned>(source);
+        REG_DMA3DAD = reinterpret_cast<unsigned>(destination);
+        REG_DMA3CNT = DMA_ENABLE | DMA_16 | halfwords;
+        while (REG_DMA3CNT & DMA_ENABLE) {}
+    }
+
+    static int eepromAddressBits(Type kind) {
+        return kind == Type::Eeprom8k ? 14 : 6;
+    }
+
+    /**
+     * Serial read request, one bit per halfword: 11, the block address MSB first, then a stop bit
+     */
+    static void eepromRead(int addressBits, int block, unsigned char *data) {
+        unsigned short request[2 + 14 + 1];
+        unsigned short reply[4 + 64];
+        int length = 0;
+        request[length++] = 1;
+        request[length++] = 1;
+        for (int bit = addressBits - 1; bit >= 0; bit--) request[length++] = (block >> bit) & 1;
+        request[length++] = 0;
+
+        unsigned short savedImeValue = REG_IME;
+        REG_IME = 0;
+        eepromTransfer(request, EEPROM_PORT, length);
+        eepromTransfer(EEPROM_PORT, reply, 4 + 64);
+        REG_IME = savedImeValue;
+
+        // Four junk bits lead the reply
+        for (int i = 0; i < EEPROM_BLOCK_SIZE; i++) {
+            unsigned char value = 0;
+            for (int bit = 0; bit < 8; bit++) value = value << 1 | (reply[4 + i * 8 + bit] & 1);
+            data[i] = value;
+        }
+    }
+
+    /**
+     * Serial write request: 10, the block address, 64 data bits, then a stop bit. Poll eepromReady for completion.
+     */
+    static void eepromStartWrite(int addressBits, int block, const unsigned char *data) {
+        unsigned short request[2 + 14 + 64 + 1];
+        int length = 0;
+        request[length++] = 1;
+        request[length++] = 0;
+        for (int bit = addressBits - 1; bit >= 0; bit--) request[length++] = (block >> bit) & 1;
+        for (int i = 0; i < EEPROM_BLOCK_SIZE; i++) {
+            for (int bit = 7; bit >= 0; bit--) request[length++] = (data[i] >> bit) & 1;
+        }
+        request[length++] = 0;
+
+        unsigned short savedImeValue = REG_IME;
+        REG_IME = 0;
+        eepromTransfer(request, EEPROM_PORT, length);
+        REG_IME = savedImeValue;
+    }
+
+    static bool eepromReady() {
+        // The chip holds the line low until the cell has been programmed, 10 ms at worst
+        return *EEPROM_PORT & 1;
+    }
+
+    static bool allOnes(const unsigned char *data) {
+        for (int i = 0; i < EEPROM_BLOCK_SIZE; i++) {
+            if (data[i] != 0xFF) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Reads are harmless at either address width, writes at the wrong one land on the wrong block.
+     * A 64 Kbit chip never sees the end of a short request and leaves the line high,
+     * so a block of ones at one width but not the other gives the size away.
+     */
+    static Type probeEepromSize() {
+        unsigned char narrow[EEPROM_BLOCK_SIZE];
+        unsigned char wide[EEPROM_BLOCK_SIZE];
+        eepromRead(6, 0, narrow);
+        eepromRead(14, 0, wide);
+        bool narrowOnes = allOnes(narrow);
+        bool wideOnes = allOnes(wide);
+        if (narrowOnes && !wideOnes) return Type::Eeprom8k;
+        if (wideOnes && !narrowOnes) return Type::Eeprom512;
+        return Type::EepromUnknownSize;
+    }
+
+    static Scan found(int offset) {
+        if (romMatches(offset, "SRAM_")) {
+            type = Type::Sram;
+        } else if (romMatches(offset, "EEPROM_V")) {
+            type = probeEepromSize();
+        } else if (romMatches(offset, "FLASH")) {
+            // The ID is the authority on size, the string only backs it up for parts we have not listed
+            chipId = readFlashId();
+            bool large = chipId == ID_MACRONIX_128K || chipId == ID_SANYO_128K || romMatches(offset, "FLASH1M_V");
+            type = large ? Type::Flash128 : Type::Flash64;
+        } else {
+            return Scan::Pending;
+        }
+        return Scan::Done;
+    }
+
+    void startDetection() {
+        CycleCounter::ensureRunning();
+        scanWord = 0;
+        type = Type::None;
+        chipId = 0;
+    }
+
+    Scan detectStep() {
+        // Header and boot code never hold the string
+        if (scanWord == 0) scanWord = 0xC0 / 4;
+        int end = scanWord + WORDS_PER_STEP;
+        for (; scanWord < end; scanWord++) {
+            if (scanWord >= ROM_LIMIT / 4 || (scanWord % (1024 * 1024 / 4) == 0 && pastRomEnd(scanWord))) {
+                return Scan::Done;
+            }
+            unsigned word = ROM_BASE[scanWord];
+            if (word != ID_SRAM && word != ID_FLASH && word != ID_EEPROM) continue;
+            if (found(scanWord * 4) == Scan::Done) return Scan::Done;
+        }
+        return Scan::Pending;
+    }
+
+    Type detectedType() {
+        return type;
+    }
+
+    unsigned short flashId() {
+        return chipId;
+    }
+
+    const char *typeName(Type kind) {
+        switch (kind) {
+            case Type::Sram:
+                return "SRAM 32 KiB";
+            case Type::Flash64:
+                return "Flash 64 KiB";
+            case Type::Flash128:
+                return "Flash 128 KiB";
+            case Type::Eeprom512:
+                return "EEPROM 512 B";
+            case Type::Eeprom8k:
+                return "EEPROM 8 KiB";
+            case Type::EepromUnknownSize:
+                return "EEPROM, size unknown";
+            default:
+                return "No save chip found";
+        }
+    }
+
+    int sizeOf(Type kind) {
+        switch (kind) {
+            case Type::Sram:
+                return SRAM_SIZE;
+            case Type::Flash64:
+                return 64 * 1024;
+            case Type::Flash128:
+                return 128 * 1024;
+            case Type::Eeprom512:
+                return 512;
+            case Type::Eeprom8k:
+                return 8 * 1024;
+            default:
+                return 0;
+        }
+    }
+
+    int sectorSize(Type kind) {
+        switch (kind) {
+            case Type::Sram:
+            case Type::Flash64:
+            case Type::Flash128:
+                return FLASH_SECTOR_SIZE;
+            case Type::Eeprom512:
+            case Type::Eeprom8k:
+                return EEPROM_BLOCK_SIZE;
+            default:
+                return 0;
+        }
+    }
+
+    bool writable(Type kind) {
+        return sizeOf(kind) > 0;
+    }
+
+    void readSector(Type kind, int sector, unsigned char *data) {
+        switch (kind) {
+            case Type::Sram:
+                for (int i = 0; i < FLASH_SECTOR_SIZE; i++) data[i] = SAVE_BASE[sector * FLASH_SECTOR_SIZE + i];
+                break;
+            case Type::Flash64:
+            case Type::Flash128: {
+                volatile unsigned char *base = flashSector(kind, sector);
+                for (int i = 0; i < FLASH_SECTOR_SIZE; i++) data[i] = base[i];
+                break;
+            }
+            case Type::Eeprom512:
+            case Type::Eeprom8k:
+                eepromRead(eepromAddressBits(kind), sector, data);
+                break;
+            default:
+                break;
+        }
+    }
+
+    static bool needsErase(Type kind) {
+        // Atmel parts erase as part of every page write
+        return (kind == Type::Flash64 || kind == Type::Flash128) && chipId != ID_ATMEL;
+    }
+
+    int chunkSize(Type kind) {
+        // One Atmel page, or as many single byte programs as comfortably fit in a slice
+        if (kind == Type::Flash64 || kind == Type::Flash128) return ATMEL_PAGE_SIZE;
+        return sectorSize(kind);
+    }
+
+    void startErase(Type kind, int sector) {
+        if (!needsErase(kind)) return;
+        volatile unsigned char *base = flashSector(kind, sector);
+        flashCommand(0x80);
+        SAVE_BASE[0x5555] = 0xAA;
+        SAVE_BASE[0x2AAA] = 0x55;
+        base[0] = 0x30;
+    }
+
+    bool eraseDone(Type kind, int sector) {
+        if (!needsErase(kind)) return true;
+        // Reads return status rather than data until the erase has finished
+        return SAVE_BASE[(sector % FLASH_BANK_SECTORS) * FLASH_SECTOR_SIZE] == 0xFF;
+    }
+
+    bool startChunk(Type kind, int sector, int offset, const unsigned char *data) {
+        switch (kind) {
+            case Type::Sram:
+                for (int i = 0; i < FLASH_SECTOR_SIZE; i++) SAVE_BASE[sector * FLASH_SECTOR_SIZE + i] = data[i];
+                return true;
+            case Type::Flash64:
+            case Type::Flash128: {
+                volatile unsigned char *base = flashSector(kind, sector) + offset;
+                if (chipId == ID_ATMEL) {
+                    // The page programs once the last byte is in, up to 20 ms, chunkDone polls for it
+                    flashCommand(0xA0);
+                    for (int i = 0; i < ATMEL_PAGE_SIZE; i++) base[i] = data[i];
+                    return true;
+                }
+                for (int i = 0; i < ATMEL_PAGE_SIZE; i++) {
+                    flashCommand(0xA0);
+                    base[i] = data[i];
+                    if (!waitUntil(base + i, data[i], CycleCounter::CYCLES_PER_SECOND / 100)) return false;
+                }
+                return true;
+            }
+            case Type::Eeprom512:
+            case Type::Eeprom8k:
+                eepromStartWrite(eepromAddressBits(kind), sector, data);
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool chunkDone(Type kind, int sector, int offset, const unsigned char *data) {
+        if (kind == Type::Eeprom512 || kind == Type::Eeprom8k) return eepromReady();
+        if ((kind != Type::Flash64 && kind != Type::Flash128) || chipId != ID_ATMEL) return true;
+        // Bank is still selected from startChunk, the last byte reads back something else until the page is written
+        int last = ATMEL_PAGE_SIZE - 1;
+        return SAVE_BASE[(sector % FLASH_BANK_SECTORS) * FLASH_SECTOR_SIZE + offset + last] == data[last];
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+/**
+ * Raw drivers for the three kinds of cart save chip, plus save type detection.
+ * Every chip is addressed in sectors: 4 KiB for SRAM and Flash, one 8 byte block for EEPROM.
+ * Nothing here keeps a copy of what it overwrites, see BackupBench for the save/restore around it.
+ */
+namespace BackupMemory {
+    enum class Type : unsigned char {
+        None, Sram, Flash64, Flash128, Eeprom512, Eeprom8k, EepromUnknownSize
+    };
+
+    enum class Scan : unsigned char {
+        Pending, Done
+    };
+
+    constexpr int MAX_SECTOR_SIZE = 4096;
+
+    /**
+     * Starts looking for the save library string the SDK links into every title
+     */
+    void startDetection();
+
+    /**
+     * Scans the next stretch of ROM, call once per frame while Pending
+     */
+    Scan detectStep();
+
+    /**
+     * Valid once detectStep has returned Done
+     */
+    Type detectedType();
+
+    /**
+     * Manufacturer in the high byte, device in the low byte, only meaningful for Flash
+     */
+    unsigned short flashId();
+
+    const char *typeName(Type type);
+
+    int sizeOf(Type type);
+
+    int sectorSize(Type type);
+
+    [[nodiscard]] inline int sectorCount(Type type) {
+        return sectorSize(type) ? sizeOf(type) / sectorSize(type) : 0;
+    }
+
+    /**
+     * Whether writes are safe, i.e. we are sure how the chip is addressed
+     */
+    bool writable(Type type);
+
+    void readSector(Type type, int sector, unsigned char *data);
+
+    /**
+     * Bytes written per startChunk call, small enough that a chunk fits in a frame budget
+     */
+    int chunkSize(Type type);
+
+    /**
+     * Kicks off a sector erase and returns straight away, poll eraseDone. Flash only, every other type is
+     * written in place and counts as erased immediately.
+     */
+    void startErase(Type type, int sector);
+
+    [[nodiscard]] bool eraseDone(Type type, int sector);
+
+    /**
+     * Sends one chunk of a sector, offset being a multiple of chunkSize, and returns without waiting for the chip
+     * to program it, poll chunkDone. Flash sectors must have been erased first. Returns false on timeout.
+     */
+    bool startChunk(Type type, int sector, int offset, const unsigned char *data);
+
+    /**
+     * Atmel pages and EEPROM blocks take milliseconds to program, every other chip is done once startChunk returns
+     */
+    [[nodiscard]] bool chunkDone(Type type, int sector, int offset, const unsigned char *data);
+}
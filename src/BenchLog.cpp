@@ -0,0 +1,58 @@
+#include "BenchLog.h"
+
+#ifdef LUCKY_BENCH
+
+#include "bn_core.h"
+#include "bn_log.h"
+#include "bn_string_view.h"
+
+#include "Profiler.h"
+
+// 228 lines of 1232 cycles
+#define CYCLES_PER_FRAME 280896
+
+namespace BenchLog {
+    static unsigned frames = 0;
+    static unsigned cpuTotal = 0;
+    static unsigned cpuMax = 0;
+    static unsigned textFrames = 0;
+    static unsigned textLines = 0;
+    static unsigned textMax = 0;
+
+    void frame(const char *before, const char *after, unsigned transitionCycles) {
+        if (bn::string_view(before) != bn::string_view(after)) {
+            if (frames) {
+                BN_LOG("BENCH,scene,", before, ",", frames, ",", cpuTotal / frames, ",", cpuMax);
+            }
+            // Close the profiler window first so every scope up to here is logged before the transition line,
+            // the bench script stops reading at the last one
+            PROFILE_FLUSH();
+            // Hundredths of a frame, OnExit flushes a frame of its own
+            BN_LOG("BENCH,transition,", before, ",", after, ",", transitionCycles * 100 / CYCLES_PER_FRAME);
+            frames = 0;
+            cpuTotal = 0;
+            cpuMax = 0;
+        }
+
+        // Hundredths of a percent of the previous frame
+        unsigned cpu = (bn::core::last_cpu_usage() * 10000).integer();
+        frames++;
+        cpuTotal += cpu;
+        if (cpu > cpuMax) cpuMax = cpu;
+    }
+
+    void text(const char *scene, int lines, unsigned cycles, bool pending) {
+        if (!lines) return;
+        textFrames++;
+        textLines += lines;
+        if (cycles > textMax) textMax = cycles;
+        if (pending) return;
+        // Worst frame in hundredths of a frame
+        BN_LOG("BENCH,text,", scene, ",", textLines, ",", textFrames, ",", textMax * 100 / CYCLES_PER_FRAME);
+        textFrames = 0;
+        textLines = 0;
+        textMax = 0;
+    }
+}
+
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+
+/**
+ * Machine readable BENCH lines on the mGBA log for `make bench`: per scene visit frame counts and
+ * CPU usage, plus how long every transition and the text it queued took. Only built into bench ROMs (make BENCH=1).
+ */
+#ifdef LUCKY_BENCH
+
+namespace BenchLog {
+    /**
+     * Call once per frame with the innermost scene before and after transitions were processed
+     */
+    void frame(const char *before, const char *after, unsigned transitionCycles);
+
+    /**
+     * Call once per frame with the queued text generated that frame, logs once the queue has drained
+     */
+    void text(const char *scene, int lines, unsigned cycles, bool pending);
+}
+
+#define BENCH_FRAME(before, after, cycles) BenchLog::frame(before, after, cycles)
+#define BENCH_TEXT(scene, lines, cycles, pending) BenchLog::text(scene, lines, cycles, pending)
+
+#else
+
+#define BENCH_FRAME(before, after, cycles)
+#define BENCH_TEXT(scene, lines, cycles, pending)
+
+#endif
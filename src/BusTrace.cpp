@@ -0,0 +1,65 @@
+#include "BusTrace.h"
+
+#ifdef LUCKY_BUS_TRACE
+
+#include "bn_common.h"
+#include "bn_string.h"
+
+#include "CycleCounter.h"
+#include "TestReport.h"
+
+namespace BusTrace {
+    /**
+     * One packed word per access:
+     * bits 0-3 pin levels, bits 4-5 register, bit 6 read, bits 8-31 cycles since the previous access (saturating)
+     */
+    BN_DATA_EWRAM_BSS static unsigned events[CAPACITY];
+    BN_DATA_EWRAM_BSS static int head;
+    BN_DATA_EWRAM_BSS static int count;
+    BN_DATA_EWRAM_BSS static unsigned lastStamp;
+
+    // Words per data line, keeps each line well inside the mGBA debug string
+    constexpr int WORDS_PER_LINE = 16;
+
+    void start() {
+        CycleCounter::ensureRunning();
+        head = 0;
+        count = 0;
+        lastStamp = CycleCounter::now();
+    }
+
+    void record(bool read, Register reg, unsigned short value) {
+        unsigned stamp = CycleCounter::now();
+        unsigned delta = stamp - lastStamp;
+        lastStamp = stamp;
+        if (delta > 0xFFFFFF) delta = 0xFFFFFF;
+
+        events[head] = delta << 8 | (read ? 1 << 6 : 0) | reg << 4 | (value & 0xF);
+        head = (head + 1) % CAPACITY;
+        if (count < CAPACITY) count++;
+    }
+
+    int exportToLog() {
+        bn::string<160> line = "LRTCTRC1 begin events=";
+        line += bn::to_string<12>(count);
+        line += " cps=";
+        line += bn::to_string<12>(static_cast<int>(CycleCounter::CYCLES_PER_SECOND));
+        TestReport::send(line);
+
+        int oldest = (head - count + CAPACITY) % CAPACITY;
+        for (int first = 0; first < count; first += WORDS_PER_LINE) {
+            line = "LRTCTRC1 data";
+            for (int i = first; i < count && i < first + WORDS_PER_LINE; i++) {
+                unsigned word = events[(oldest + i) % CAPACITY];
+                line += ' ';
+                for (int shift = 28; shift >= 0; shift -= 4) line += "0123456789ABCDEF"[(word >> shift) & 0xF];
+            }
+            TestReport::send(line);
+        }
+
+        TestReport::send("LRTCTRC1 end");
+        return count;
+    }
+}
+
+#endif
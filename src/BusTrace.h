@@ -0,0 +1,62 @@
+#pragma once
+
+/**
+ * Optional capture of every GPIO register access made by the RTC bit-banging routines.
+ * Trace builds (make TRACE=1) swap REG_DAT/REG_DIR/REG_CTL for proxies that log into an EWRAM ring buffer,
+ * other builds keep the bare volatile registers so tracing costs nothing.
+ * Hold L+R for two seconds to send the buffer out as text lines through TestReport (mGBA log or link port UART),
+ * tools/trace/replay.py decodes a capture of them. The cart's save is never touched.
+ */
+#ifdef LUCKY_BUS_TRACE
+
+namespace BusTrace {
+    enum Register : unsigned char {
+        DAT, DIR, CTL
+    };
+
+    // Events the ring buffer holds before overwriting the oldest
+    constexpr int CAPACITY = 4096;
+
+    void start();
+
+    void record(bool read, Register reg, unsigned short value);
+
+    // Frames L+R must be held together before the trace goes out
+    constexpr int EXPORT_HOLD_FRAMES = 120;
+
+    /**
+     * Sends the buffer oldest first as hex lines:
+     *     LRTCTRC1 begin events=812 cps=16777216
+     *     LRTCTRC1 data 00012345 0000A312 ...
+     *     LRTCTRC1 end
+     * Over UART the full buffer takes a few seconds and the game stalls meanwhile. Returns events sent.
+     */
+    int exportToLog();
+
+    template<Register reg>
+    struct Port {
+        static volatile unsigned short &raw() {
+            return *reinterpret_cast<volatile unsigned short *>(0x080000C4 + reg * 2);
+        }
+
+        Port &operator=(unsigned short value) {
+            raw() = value;
+            record(false, reg, value);
+            return *this;
+        }
+
+        operator unsigned short() const {
+            unsigned short value = raw();
+            record(true, reg, value);
+            return value;
+        }
+    };
+}
+
+#define BUS_TRACE_INIT() BusTrace::start()
+
+#else
+
+#define BUS_TRACE_INIT()
+
+#endif
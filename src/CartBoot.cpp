@@ -0,0 +1,63 @@
+#include "CartBoot.h"
+
+#define REG_DISPCNT *((volatile unsigned short *)0x04000000)
+#define REG_IE *((volatile unsigned short *)0x04000200)
+#define REG_IF *((volatile unsigned short *)0x04000202)
+#define REG_WAITCNT *((volatile unsigned short *)0x04000204)
+#define REG_IME *((volatile unsigned short *)0x04000208)
+#define REG_DMA_CNT(channel) *((volatile unsigned short *)(0x040000BA + (channel) * 12))
+#define REG_TM_CNT(timer) *((volatile unsigned short *)(0x04000102 + (timer) * 4))
+
+#define GPIO_DAT *((volatile unsigned short *)0x080000C4)
+#define GPIO_DIR *((volatile unsigned short *)0x080000C6)
+#define GPIO_CTL *((volatile unsigned short *)0x080000C8)
+
+#define ROM_HEADER ((volatile unsigned char *)0x080000A0)
+// Complement of the sum of title, code, maker, unit, device type and version, checked by the BIOS on a cold boot
+#define HEADER_COMPLEMENT_OFFSET 0x1D
+
+// Soft reset boots ROM rather than EWRAM while this byte is zero
+#define RESET_FLAG *((volatile unsigned char *)0x03007FFA)
+
+#define DISPLAY_FORCED_BLANK 0x0080
+
+namespace CartBoot {
+    bool bootable() {
+        unsigned char sum = 0;
+        for (int i = 0; i < HEADER_COMPLEMENT_OFFSET; i++) sum += ROM_HEADER[i];
+        return static_cast<unsigned char>(-(sum + 0x19)) == ROM_HEADER[HEADER_COMPLEMENT_OFFSET];
+    }
+
+    void handOff() {
+        REG_IME = 0;
+        REG_IE = 0;
+        REG_IF = 0xFFFF;
+        for (int channel = 0; channel < 4; channel++) REG_DMA_CNT(channel) = 0;
+        for (int timer = 0; timer < 4; timer++) REG_TM_CNT(timer) = 0;
+        REG_DISPCNT = DISPLAY_FORCED_BLANK;
+
+        // RTC deselected and the port back to write only, as games expect to find it
+        GPIO_DAT = 0;
+        GPIO_DIR = 0;
+        GPIO_CTL = 0;
+
+        // The BIOS leaves every wait state at its slowest; games set their own
+        REG_WAITCNT = 0;
+        RESET_FLAG = 0;
+
+        // RegisterRamReset clears IWRAM, where our stack lives, so nothing may touch memory between the two calls.
+        // 0xFE: everything but EWRAM, which this multiboot image is running from.
+        asm volatile(
+#ifdef __thumb__
+                "mov r0, #0xFE\n"
+                "swi 0x01\n"
+                "swi 0x00\n"
+#else
+                "mov r0, #0xFE\n"
+                "swi 0x010000\n"
+                "swi 0x000000\n"
+#endif
+                ::: "r0", "r1", "r2", "r3", "memory");
+        __builtin_unreachable();
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+/**
+ * Hands the console over to the inserted cart without a power cycle.
+ * Everything we touched is put back the way the BIOS leaves it, then the BIOS soft reset jumps straight to the
+ * cart entry point at 0x08000000, skipping the logo and the header check of a full boot.
+ */
+namespace CartBoot {
+    /**
+     * Cheap sanity check of the cart header, so an empty slot or a half seated cart is never jumped into
+     */
+    [[nodiscard]] bool bootable();
+
+    /**
+     * Quiesces interrupts, DMA, display and the GPIO port, restores post-BIOS I/O state and boots the cart.
+     * Stop the music and let one frame go by first so the mixer doesn't cut out mid-sample.
+     */
+    [[noreturn]] void handOff();
+}
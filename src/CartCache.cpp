@@ -0,0 +1,38 @@
+#include "CartCache.h"
+
+#include "bn_common.h"
+
+namespace CartCache {
+    BN_DATA_EWRAM_BSS static Entry entries[CAPACITY];
+    BN_DATA_EWRAM_BSS static int used;
+    BN_DATA_EWRAM_BSS static unsigned clock;
+
+    static Entry *locate(unsigned short signature, unsigned gameCode) {
+        for (int i = 0; i < used; i++) {
+            Entry &entry = entries[i];
+            if (entry.signature == signature && entry.gameCode == gameCode) return &entry;
+        }
+        return nullptr;
+    }
+
+    const Entry *find(unsigned short signature, unsigned gameCode) {
+        Entry *entry = locate(signature, gameCode);
+        if (entry) entry->lastUsed = ++clock;
+        return entry;
+    }
+
+    void store(unsigned short signature, unsigned gameCode, unsigned short status, Presence presence,
+               unsigned lastSeenDate, unsigned lastSeenTime) {
+        Entry *entry = locate(signature, gameCode);
+        if (!entry && used < CAPACITY) {
+            entry = &entries[used++];
+        } else if (!entry) {
+            // Full, recycle whichever cart has been out of the slot the longest
+            entry = &entries[0];
+            for (int i = 1; i < CAPACITY; i++) {
+                if (entries[i].lastUsed < entry->lastUsed) entry = &entries[i];
+            }
+        }
+        *entry = {gameCode, signature, status, presence, lastSeenDate, lastSeenTime, ++clock};
+    }
+}
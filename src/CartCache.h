@@ -0,0 +1,33 @@
+#pragma once
+
+/**
+ * Remembers what the last few carts looked like so a reinserted cart can show a result
+ * straight away while the bus is asked again in the background.
+ * Lives in EWRAM, evicts the least recently seen cart once full.
+ */
+namespace CartCache {
+    enum class Presence : unsigned char {
+        Missing, Dead, Full, Error
+    };
+
+    struct Entry {
+        unsigned gameCode;
+        unsigned short signature;
+        unsigned short status;
+        Presence presence;
+        // Raw agbabi datetime words from the last time the chip was read
+        unsigned lastSeenDate;
+        unsigned lastSeenTime;
+        unsigned lastUsed;
+    };
+
+    constexpr int CAPACITY = 16;
+
+    /**
+     * Returns the cached result for this header, nullptr if we haven't seen it this session
+     */
+    const Entry *find(unsigned short signature, unsigned gameCode);
+
+    void store(unsigned short signature, unsigned gameCode, unsigned short status, Presence presence,
+               unsigned lastSeenDate, unsigned lastSeenTime);
+}
@@ -0,0 +1,89 @@
+#include "CartMonitor.h"
+
+#include "bn_hw_irq.h"
+
+#include "WaitTuner.h"
+
+#define REG_NAM ((volatile unsigned short *)0x080000A0)
+#define REG_GAME_CODE ((volatile unsigned short *)0x080000AC)
+// Software version and complement check, differs between almost all retail titles
+#define HEADER_SIGNATURE *(volatile unsigned short *)(0x080000BC)
+// An empty slot floats the bus to the low half of the address being read
+#define OPEN_BUS_SIGNATURE 0x005E
+
+static volatile bool irqLatched = false;
+static volatile unsigned removalCount = 0;
+
+static void onCartIrq() {
+    // Whatever comes next gets the safe timing until it has been tuned for
+    WaitTuner::restoreDefaults();
+    irqLatched = true;
+    removalCount++;
+}
+
+static bool isPrintable(int c) {
+    return ' ' <= c && c <= '~';
+}
+
+CartMonitor::CartMonitor() {
+    bn::hw::irq::set_isr(bn::hw::irq::id::GAMEPAK, onCartIrq);
+    bn::hw::irq::enable(bn::hw::irq::id::GAMEPAK);
+}
+
+unsigned CartMonitor::removals() {
+    return removalCount;
+}
+
+bool CartMonitor::update() {
+    if (irqLatched) {
+        // Cart was pulled, nothing on the bus can be trusted until it settles again
+        irqLatched = false;
+        invalidate();
+    }
+    if (held || !armed) return false;
+
+    unsigned short sample = HEADER_SIGNATURE;
+    if (sample == candidateSignature) {
+        if (stableFrames < SETTLE_FRAMES) stableFrames++;
+    } else {
+        candidateSignature = sample;
+        stableFrames = 1;
+    }
+    if (stableFrames < SETTLE_FRAMES) return false;
+    // Already reported this slot state, keep watching for an insertion
+    if (confirmed && settledSignature == sample) return false;
+
+    settledSignature = sample;
+    confirmed = true;
+    readHeader();
+    confirmedGeneration++;
+    // Inserting a cart does not raise the interrupt, so an empty slot stays on the cheap sample
+    armed = !cartPresent();
+    return true;
+}
+
+void CartMonitor::invalidate() {
+    armed = true;
+    confirmed = false;
+    stableFrames = 0;
+}
+
+bool CartMonitor::cartPresent() const {
+    return settledSignature != OPEN_BUS_SIGNATURE;
+}
+
+void CartMonitor::readHeader() {
+    code = REG_GAME_CODE[0] | static_cast<unsigned>(REG_GAME_CODE[1]) << 16;
+
+    // Straight from the header into the title, stopping at the first unprintable byte
+    title.clear();
+    for (int i = 0; i < 6; ++i) {
+        unsigned short word = REG_NAM[i];
+        char low = static_cast<char>(word & 0xFF);
+        if (!isPrintable(low)) return;
+        title.push_back(low);
+        char high = static_cast<char>((word >> 8) & 0xFF);
+        if (!isPrintable(high)) return;
+        title.push_back(high);
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "bn_string.h"
+
+/**
+ * Watches the cartridge slot for hot-swaps without polling the cart header every frame.
+ * The Game Pak interrupt latches a removal, after which a single header halfword is sampled
+ * once per frame until it has held steady long enough for the bus to settle.
+ * The game title and code are only read from the header once a swap has been confirmed.
+ */
+class CartMonitor {
+public:
+    CartMonitor();
+
+    /**
+     * Call once per frame. Returns true on the frame a (re)insertion is confirmed.
+     */
+    bool update();
+
+    /**
+     * Forces the header to be re-sampled, e.g. after the cart has been remapped.
+     */
+    void invalidate();
+
+    /**
+     * While held the header is never sampled, for when something else owns the cart mapping.
+     */
+    void setHeld(bool value) {
+        held = value;
+    }
+
+    /**
+     * Bumped on every confirmed swap so consumers can tell whether they are up to date.
+     */
+    [[nodiscard]] unsigned generation() const {
+        return confirmedGeneration;
+    }
+
+    [[nodiscard]] const bn::string<12> &gameTitle() const {
+        return title;
+    }
+
+    /**
+     * Four character game code as read off the bus, see GameDatabase::makeCode
+     */
+    [[nodiscard]] unsigned gameCode() const {
+        return code;
+    }
+
+    [[nodiscard]] unsigned short signature() const {
+        return settledSignature;
+    }
+
+    [[nodiscard]] bool cartPresent() const;
+
+    /**
+     * Bumped straight from the Game Pak interrupt, long before a swap settles into a new generation.
+     * Anything writing to the cart snapshots it first and stops the moment it moves.
+     */
+    [[nodiscard]] static unsigned removals();
+
+private:
+    // Frames the signature must hold before we trust the bus again
+    static constexpr int SETTLE_FRAMES = 8;
+
+    bool held = false;
+    bool armed = true;
+    bool confirmed = false;
+    int stableFrames = 0;
+    unsigned confirmedGeneration = 0;
+    unsigned short candidateSignature = 0;
+    unsigned short settledSignature = 0;
+    bn::string<12> title;
+    unsigned code = 0;
+
+    void readHeader();
+};
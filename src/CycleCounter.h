@@ -0,0 +1,73 @@
+#pragma once
+
+#include "bn_assert.h"
+
+#define CYCLE_TM2_DATA *((volatile unsigned short *)0x04000108)
+#define CYCLE_TM2_CNT *((volatile unsigned short *)0x0400010A)
+#define CYCLE_TM3_DATA *((volatile unsigned short *)0x0400010C)
+#define CYCLE_TM3_CNT *((volatile unsigned short *)0x0400010E)
+
+#define CYCLE_TM_ENABLE 0x0080
+#define CYCLE_TM_CASCADE 0x0004
+// Control values of a running counter: TM2 at the 1 cycle prescaler, TM3 counting TM2 overflows, no interrupts
+#define CYCLE_TM2_RUNNING CYCLE_TM_ENABLE
+#define CYCLE_TM3_RUNNING (CYCLE_TM_ENABLE | CYCLE_TM_CASCADE)
+
+/**
+ * Free running 32-bit counter on cascaded TM2/TM3, ticking once per system clock (16.78 MHz).
+ * TM2 and TM3 are reserved for it, nothing else in the project may touch them. butano's bn::timer (the boot timer
+ * in main.cpp) and audio keep timers of their own; if a butano update ever takes these two, start() asserts instead of
+ * both sides silently reading each other's counts.
+ */
+namespace CycleCounter {
+    constexpr unsigned CYCLES_PER_SECOND = 16777216;
+
+    /**
+     * True while TM2/TM3 are either stopped or counting as set up by start()
+     */
+    inline bool timersFree() {
+        unsigned short tm2 = CYCLE_TM2_CNT;
+        unsigned short tm3 = CYCLE_TM3_CNT;
+        return !((tm2 | tm3) & CYCLE_TM_ENABLE) || (tm2 == CYCLE_TM2_RUNNING && tm3 == CYCLE_TM3_RUNNING);
+    }
+
+    inline void start() {
+        BN_ASSERT(timersFree(), "TM2/TM3 in use by something other than CycleCounter");
+        CYCLE_TM2_CNT = 0;
+        CYCLE_TM3_CNT = 0;
+        // Writing the data registers sets the reload value picked up on enable
+        CYCLE_TM2_DATA = 0;
+        CYCLE_TM3_DATA = 0;
+        CYCLE_TM3_CNT = CYCLE_TM3_RUNNING;
+        CYCLE_TM2_CNT = CYCLE_TM2_RUNNING;
+    }
+
+    /**
+     * Starts the counter unless it is already running as set up by start(), e.g. for the profiler.
+     * Only the enable bit matching is not enough: with another prescaler or without the cascade the timers would be
+     * counting something else, and start() then asserts rather than take them over.
+     */
+    inline void ensureRunning() {
+        if (CYCLE_TM2_CNT != CYCLE_TM2_RUNNING || CYCLE_TM3_CNT != CYCLE_TM3_RUNNING) start();
+    }
+
+    inline void stop() {
+        CYCLE_TM2_CNT = 0;
+        CYCLE_TM3_CNT = 0;
+    }
+
+    inline unsigned now() {
+        unsigned short high = CYCLE_TM3_DATA;
+        unsigned short low = CYCLE_TM2_DATA;
+        // Low half wrapped between the two reads, take both again
+        if (CYCLE_TM3_DATA != high) {
+            high = CYCLE_TM3_DATA;
+            low = CYCLE_TM2_DATA;
+        }
+        return static_cast<unsigned>(high) << 16 | low;
+    }
+
+    inline unsigned toMicroseconds(unsigned cycles) {
+        return static_cast<unsigned>(static_cast<unsigned long long>(cycles) * 1000000 / CYCLES_PER_SECOND);
+    }
+}
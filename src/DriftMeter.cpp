@@ -0,0 +1,144 @@
+#include "DriftMeter.h"
+
+#include <cmath>
+
+#include "CycleCounter.h"
+
+// 228 lines of 1232 cycles
+#define CYCLES_PER_FRAME 280896
+// Half width of the polling window around a predicted tick, roughly 4ms
+#define WINDOW_CYCLES 65536
+// Calls this close to the predicted tick are too late to see it from the quiet side
+#define EDGE_GUARD 8192
+
+void DriftMeter::start() {
+    CycleCounter::ensureRunning();
+    *this = DriftMeter();
+    lastRaw = CycleCounter::now();
+}
+
+unsigned long long DriftMeter::now() {
+    unsigned raw = CycleCounter::now();
+    // Wraps every 256 seconds, we're called at least once a frame
+    if (raw < lastRaw) high += 1ull << 32;
+    lastRaw = raw;
+    return high | raw;
+}
+
+bool DriftMeter::acquire(ClockReader read, unsigned long long time) {
+    // One read a frame, so a tick is only known to lie between two calls
+    int value = read();
+    if (haveLast && value != last) {
+        unsigned long long earliest = lastCall;
+        unsigned long long latest = time;
+        if (bracketed) {
+            // Ticks are a second apart and the frame phase moves on by about a quarter frame each second,
+            // so overlapping consecutive brackets closes in on the tick within a few seconds
+            unsigned long long previousEarliest = edgeLow + CycleCounter::CYCLES_PER_SECOND;
+            unsigned long long previousLatest = edgeHigh + CycleCounter::CYCLES_PER_SECOND;
+            if (previousEarliest > earliest) earliest = previousEarliest;
+            if (previousLatest < latest) latest = previousLatest;
+            if (earliest > latest) {
+                // Misread or a step in the clock, start over from this bracket
+                earliest = lastCall;
+                latest = time;
+            }
+        }
+        edgeLow = earliest;
+        edgeHigh = latest;
+        bracketed = true;
+        if (latest - earliest <= WINDOW_CYCLES) {
+            locked = true;
+            predicted = earliest + (latest - earliest) / 2 + CycleCounter::CYCLES_PER_SECOND;
+        }
+    }
+    last = value;
+    haveLast = true;
+    lastCall = time;
+    return false;
+}
+
+bool DriftMeter::update(ClockReader read) {
+    unsigned long long time = now();
+    if (!locked) return acquire(read, time);
+
+    // Never wait for a window to open, that would spin away most of a frame. The tick's phase against the frame
+    // moves on by about a quarter frame every second, so a later second lands a call inside its window.
+    if (time + EDGE_GUARD > predicted) {
+        predicted += CycleCounter::CYCLES_PER_SECOND;
+        return false;
+    }
+    if (time + WINDOW_CYCLES < predicted) return false;
+
+    unsigned long long previous = now();
+    last = read();
+    unsigned long long deadline = predicted + WINDOW_CYCLES;
+    for (;;) {
+        unsigned long long sample = now();
+        int value = read();
+        if (value != last) {
+            // Rolled over somewhere between the two samples
+            last = value;
+            unsigned long long edge = previous + (sample - previous) / 2;
+            record(edge);
+            predicted = edge + CycleCounter::CYCLES_PER_SECOND;
+            return true;
+        }
+        previous = sample;
+        if (sample > deadline) {
+            // Lost the tick, go back to bracketing it
+            locked = false;
+            bracketed = false;
+            haveLast = false;
+            missed++;
+            return false;
+        }
+    }
+}
+
+void DriftMeter::record(unsigned long long edge) {
+    if (!count) firstEdge = edge;
+    unsigned long long sinceFirst = edge - firstEdge;
+    auto index = static_cast<unsigned>((sinceFirst + CycleCounter::CYCLES_PER_SECOND / 2) /
+                                       CycleCounter::CYCLES_PER_SECOND);
+    // Regress the offset from a nominal clock rather than raw cycles, keeps the numbers small
+    double x = index;
+    double y = static_cast<double>(static_cast<long long>(sinceFirst) -
+                                   static_cast<long long>(index) * CycleCounter::CYCLES_PER_SECOND);
+
+    count++;
+    double dx = x - meanX;
+    meanX += dx / count;
+    double dy = y - meanY;
+    meanY += dy / count;
+    comomentXX += dx * (x - meanX);
+    comomentXY += dx * (y - meanY);
+    comomentYY += dy * (y - meanY);
+    lastIndex = index;
+}
+
+double DriftMeter::slope() const {
+    // Extra system cycles per RTC second
+    return comomentXX > 0 ? comomentXY / comomentXX : 0;
+}
+
+int DriftMeter::driftTenthsPpm() const {
+    double extra = slope();
+    double ppm = -extra / (CycleCounter::CYCLES_PER_SECOND + extra) * 1e6;
+    return static_cast<int>(std::lround(ppm * 10));
+}
+
+int DriftMeter::confidenceTenthsPpm() const {
+    if (!hasEstimate() || comomentXX <= 0) return 0;
+    double residual = comomentYY - slope() * comomentXY;
+    if (residual < 0) residual = 0;
+    double standardError = std::sqrt(residual / (count - 2) / comomentXX);
+
+    // Two sided 95% Student's t, settles on the normal value once there's plenty of samples
+    static constexpr double t[] = {12.71, 4.30, 3.18, 2.78, 2.57};
+    int degrees = count - 2;
+    double critical = degrees <= 5 ? t[degrees - 1] : degrees <= 10 ? 2.23 : degrees <= 30 ? 2.04 : 1.96;
+
+    double ppm = critical * standardError / CycleCounter::CYCLES_PER_SECOND * 1e6;
+    return static_cast<int>(std::lround(ppm * 10));
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+/**
+ * Measures RTC oscillator drift against the 16.78 MHz system clock.
+ * The tick is first bracketed with one RTC read a frame. Once it is known to a few milliseconds, second rollovers are
+ * timestamped by polling only when a frame's call already falls inside the window around a predicted tick, so no call
+ * waits for a window to open and the rest of the frame is left to sit in Halt waiting for VBlank.
+ * Drift is the least squares slope of edge timestamps over elapsed RTC seconds.
+ */
+class DriftMeter {
+public:
+    /**
+     * Reads the RTC time, any value that changes on every second rollover will do
+     */
+    using ClockReader = int (*)();
+
+    void start();
+
+    /**
+     * Call once per frame. Returns true when a new second edge was timestamped, which takes a few seconds between
+     * edges as the window has to line up with a call.
+     */
+    bool update(ClockReader read);
+
+    [[nodiscard]] int edges() const {
+        return count;
+    }
+
+    [[nodiscard]] int missedWindows() const {
+        return missed;
+    }
+
+    [[nodiscard]] unsigned elapsedSeconds() const {
+        return lastIndex;
+    }
+
+    [[nodiscard]] bool hasEstimate() const {
+        return count >= 3;
+    }
+
+    /**
+     * Positive when the RTC runs fast, in tenths of a ppm
+     */
+    [[nodiscard]] int driftTenthsPpm() const;
+
+    /**
+     * Half width of the 95% confidence interval, in tenths of a ppm
+     */
+    [[nodiscard]] int confidenceTenthsPpm() const;
+
+private:
+    bool locked = false;
+    bool haveLast = false;
+    int last = 0;
+    unsigned long long predicted = 0;
+
+    // Where the last tick seen during acquisition can have been, narrowed down across seconds
+    bool bracketed = false;
+    unsigned long long lastCall = 0;
+    unsigned long long edgeLow = 0;
+    unsigned long long edgeHigh = 0;
+
+    // 64-bit extension of the wrapping cycle counter
+    unsigned lastRaw = 0;
+    unsigned long long high = 0;
+
+    int count = 0;
+    int missed = 0;
+    unsigned long long firstEdge = 0;
+    unsigned lastIndex = 0;
+
+    // Running regression of (seconds, cycles past nominal) kept as centred co-moments for stability
+    double meanX = 0, meanY = 0, comomentXY = 0, comomentXX = 0, comomentYY = 0;
+
+    unsigned long long now();
+
+    bool acquire(ClockReader read, unsigned long long time);
+
+    void record(unsigned long long edge);
+
+    [[nodiscard]] double slope() const;
+};
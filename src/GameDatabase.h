@@ -0,0 +1,138 @@
+#pragma once
+
+#include "bn_string_view.h"
+
+/**
+ * Built-in table of retail titles whose carts we know the GPIO contents of.
+ * Keyed by the four character game code at 0x080000AC, looked up through a perfect hash
+ * that is fully resolved at compile time.
+ */
+namespace GameDatabase {
+    enum class RtcChip : unsigned char {
+        None, S3511A
+    };
+
+    enum Peripheral : unsigned char {
+        PERIPHERAL_NONE = 0,
+        PERIPHERAL_SOLAR = 1 << 0,
+        PERIPHERAL_GYRO = 1 << 1,
+        PERIPHERAL_RUMBLE = 1 << 2,
+    };
+
+    struct GameInfo {
+        unsigned code;
+        bn::string_view name;
+        RtcChip rtc;
+        unsigned char peripherals;
+    };
+
+    /**
+     * Packs a game code the same way it reads off the cart bus as a little endian word
+     */
+    constexpr unsigned makeCode(const char (&code)[5]) {
+        return static_cast<unsigned char>(code[0]) | static_cast<unsigned char>(code[1]) << 8 |
+               static_cast<unsigned char>(code[2]) << 16 | static_cast<unsigned>(static_cast<unsigned char>(code[3])) << 24;
+    }
+
+    constexpr GameInfo games[] = {
+            {makeCode("AXVJ"), "Pokemon Ruby", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("AXVE"), "Pokemon Ruby", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("AXVP"), "Pokemon Ruby", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("AXVD"), "Pokemon Ruby", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("AXVF"), "Pokemon Ruby", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("AXVI"), "Pokemon Ruby", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("AXVS"), "Pokemon Ruby", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("AXPJ"), "Pokemon Sapphire", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("AXPE"), "Pokemon Sapphire", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("AXPP"), "Pokemon Sapphire", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("AXPD"), "Pokemon Sapphire", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("AXPF"), "Pokemon Sapphire", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("AXPI"), "Pokemon Sapphire", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("AXPS"), "Pokemon Sapphire", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("BPEJ"), "Pokemon Emerald", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("BPEE"), "Pokemon Emerald", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("BPEP"), "Pokemon Emerald", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("BPED"), "Pokemon Emerald", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("BPEF"), "Pokemon Emerald", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("BPEI"), "Pokemon Emerald", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("BPES"), "Pokemon Emerald", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("U3IJ"), "Bokura no Taiyou", RtcChip::S3511A, PERIPHERAL_SOLAR},
+            {makeCode("U3IE"), "Boktai", RtcChip::S3511A, PERIPHERAL_SOLAR},
+            {makeCode("U3IP"), "Boktai", RtcChip::S3511A, PERIPHERAL_SOLAR},
+            {makeCode("U32J"), "Zoku Bokura no Taiyou", RtcChip::S3511A, PERIPHERAL_SOLAR},
+            {makeCode("U32E"), "Boktai 2", RtcChip::S3511A, PERIPHERAL_SOLAR},
+            {makeCode("U32P"), "Boktai 2", RtcChip::S3511A, PERIPHERAL_SOLAR},
+            {makeCode("U33J"), "Shin Bokura no Taiyou", RtcChip::S3511A, PERIPHERAL_SOLAR},
+            {makeCode("BKAJ"), "Sennen Kazoku", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("BR4J"), "Rockman EXE 4.5", RtcChip::S3511A, PERIPHERAL_NONE},
+            {makeCode("RZWJ"), "Mawaru Made in Wario", RtcChip::None, PERIPHERAL_GYRO | PERIPHERAL_RUMBLE},
+            {makeCode("RZWE"), "WarioWare: Twisted!", RtcChip::None, PERIPHERAL_GYRO | PERIPHERAL_RUMBLE},
+            {makeCode("RZWP"), "WarioWare: Twisted!", RtcChip::None, PERIPHERAL_GYRO | PERIPHERAL_RUMBLE},
+            {makeCode("V49J"), "Screw Breaker", RtcChip::None, PERIPHERAL_RUMBLE},
+            {makeCode("V49E"), "Drill Dozer", RtcChip::None, PERIPHERAL_RUMBLE},
+            {makeCode("V49P"), "Drill Dozer", RtcChip::None, PERIPHERAL_RUMBLE},
+            {makeCode("BPRJ"), "Pokemon FireRed", RtcChip::None, PERIPHERAL_NONE},
+            {makeCode("BPRE"), "Pokemon FireRed", RtcChip::None, PERIPHERAL_NONE},
+            {makeCode("BPRP"), "Pokemon FireRed", RtcChip::None, PERIPHERAL_NONE},
+            {makeCode("BPGJ"), "Pokemon LeafGreen", RtcChip::None, PERIPHERAL_NONE},
+            {makeCode("BPGE"), "Pokemon LeafGreen", RtcChip::None, PERIPHERAL_NONE},
+            {makeCode("BPGP"), "Pokemon LeafGreen", RtcChip::None, PERIPHERAL_NONE},
+            {makeCode("A88J"), "Mario & Luigi RPG", RtcChip::None, PERIPHERAL_NONE},
+            {makeCode("A88E"), "Mario & Luigi: Superstar Saga", RtcChip::None, PERIPHERAL_NONE},
+            {makeCode("A88P"), "Mario & Luigi: Superstar Saga", RtcChip::None, PERIPHERAL_NONE},
+    };
+
+    constexpr int GAME_COUNT = sizeof(games) / sizeof(games[0]);
+    constexpr int SLOT_BITS = 7;
+    constexpr int SLOT_COUNT = 1 << SLOT_BITS;
+    constexpr unsigned char EMPTY_SLOT = 0xFF;
+
+    static_assert(GAME_COUNT < EMPTY_SLOT, "Slot indices are bytes");
+
+    constexpr unsigned slotFor(unsigned code, unsigned seed) {
+        return ((code ^ seed) * 0x9E3779B1u) >> (32 - SLOT_BITS);
+    }
+
+    constexpr bool seedIsPerfect(unsigned seed) {
+        bool used[SLOT_COUNT]{};
+        for (const GameInfo &game: games) {
+            unsigned slot = slotFor(game.code, seed);
+            if (used[slot]) return false;
+            used[slot] = true;
+        }
+        return true;
+    }
+
+    constexpr unsigned findSeed() {
+        unsigned seed = 0;
+        while (!seedIsPerfect(seed)) seed++;
+        return seed;
+    }
+
+    constexpr unsigned SEED = findSeed();
+
+    struct SlotTable {
+        unsigned char index[SLOT_COUNT];
+    };
+
+    constexpr SlotTable buildSlots() {
+        SlotTable table{};
+        for (unsigned char &slot: table.index) slot = EMPTY_SLOT;
+        for (int i = 0; i < GAME_COUNT; i++) table.index[slotFor(games[i].code, SEED)] = i;
+        return table;
+    }
+
+    constexpr SlotTable slots = buildSlots();
+
+    /**
+     * O(1) lookup, nullptr for titles we know nothing about
+     */
+    constexpr const GameInfo *lookup(unsigned code) {
+        unsigned char index = slots.index[slotFor(code, SEED)];
+        if (index == EMPTY_SLOT || games[index].code != code) return nullptr;
+        return &games[index];
+    }
+
+    static_assert(lookup(makeCode("BPEE")) == &games[15], "Perfect hash must resolve every entry");
+    static_assert(lookup(makeCode("ZZZZ")) == nullptr, "Unknown codes must miss");
+}
@@ -0,0 +1,78 @@
+#include "GlyphAtlas.h"
+
+#include "bn_sprite_item.h"
+
+GlyphAtlas::GlyphAtlas(const bn::sprite_font &font) :
+        font(font), fontPalette(font.item().palette_item().create_palette()) {
+}
+
+const bn::sprite_tiles_ptr &GlyphAtlas::acquire(char character) {
+    // Sprite fonts start at the space character
+    int index = character - ' ';
+    if (!users[index]++) tiles[index] = font.item().tiles_item().create_tiles(index);
+    return *tiles[index];
+}
+
+void GlyphAtlas::release(char character) {
+    int index = character - ' ';
+    if (!--users[index]) tiles[index].reset();
+}
+
+int GlyphAtlas::advance(char character) const {
+    const auto &widths = font.character_widths_ref();
+    int index = character - ' ';
+    int width = widths.empty() || index < 0 || index >= widths.size() ? shapeSize().width() : widths[index];
+    return width + font.space_between_characters();
+}
+
+int GlyphAtlas::residentGlyphs() const {
+    int count = 0;
+    for (unsigned short glyphUsers: users) {
+        if (glyphUsers) count++;
+    }
+    return count;
+}
+
+void GlyphLine::set(GlyphAtlas &value, bn::fixed x, bn::fixed y, const bn::string_view &text) {
+    if (atlas != &value) clear();
+    atlas = &value;
+
+    int width = 0;
+    for (char character: text) width += atlas->advance(character);
+    bn::fixed left = x - width / 2;
+    int halfGlyph = atlas->shapeSize().width() / 2;
+
+    int used = 0;
+    for (char character: text) {
+        if (GlyphAtlas::drawable(character) && used < MAX_GLYPHS) {
+            bn::fixed glyphX = left + halfGlyph;
+            if (used < sprites.size()) {
+                if (glyphs[used] != character) {
+                    sprites[used].set_tiles(atlas->acquire(character));
+                    atlas->release(glyphs[used]);
+                    glyphs[used] = character;
+                }
+                sprites[used].set_position(glyphX, y);
+            } else {
+                sprites.push_back(bn::sprite_ptr::create(glyphX, y, atlas->shapeSize(), atlas->acquire(character),
+                                                         atlas->palette()));
+                glyphs.push_back(character);
+            }
+            used++;
+        }
+        left += atlas->advance(character);
+    }
+
+    while (sprites.size() > used) {
+        sprites.pop_back();
+        atlas->release(glyphs.back());
+        glyphs.pop_back();
+    }
+}
+
+void GlyphLine::clear() {
+    if (!atlas) return;
+    sprites.clear();
+    for (char character: glyphs) atlas->release(character);
+    glyphs.clear();
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "bn_fixed.h"
+#include "bn_optional.h"
+#include "bn_sprite_font.h"
+#include "bn_sprite_palette_ptr.h"
+#include "bn_sprite_ptr.h"
+#include "bn_sprite_tiles_ptr.h"
+#include "bn_string_view.h"
+#include "bn_vector.h"
+
+/**
+ * One copy in VRAM per printable ASCII glyph of a sprite font, shared by every GlyphLine drawing it.
+ * Tiles are uploaded on first use and let go once no line shows that glyph any more.
+ */
+class GlyphAtlas {
+public:
+    explicit GlyphAtlas(const bn::sprite_font &font);
+
+    [[nodiscard]] static bool drawable(char character) {
+        return ' ' < character && character <= '~';
+    }
+
+    /**
+     * Only for drawable characters, pair every call with a release
+     */
+    const bn::sprite_tiles_ptr &acquire(char character);
+
+    void release(char character);
+
+    /**
+     * Pixels from the start of this character to the start of the next, as the text generator lays them out
+     */
+    [[nodiscard]] int advance(char character) const;
+
+    [[nodiscard]] const bn::sprite_palette_ptr &palette() const {
+        return fontPalette;
+    }
+
+    [[nodiscard]] bn::sprite_shape_size shapeSize() const {
+        return font.item().shape_size();
+    }
+
+    /**
+     * Glyphs currently held in VRAM
+     */
+    [[nodiscard]] int residentGlyphs() const;
+
+private:
+    static constexpr int GLYPH_COUNT = '~' - ' ' + 1;
+
+    const bn::sprite_font &font;
+    bn::sprite_palette_ptr fontPalette;
+    bn::optional<bn::sprite_tiles_ptr> tiles[GLYPH_COUNT];
+    unsigned short users[GLYPH_COUNT]{};
+};
+
+/**
+ * A single line of text with one 8x16 sprite per glyph, all pointing into the atlas.
+ * Setting new text only retargets and moves the sprites that changed, so a clock ticking over is a handful of
+ * OAM updates instead of a fresh tile upload. Costs more sprites than the text generator's 32 pixel wide
+ * blocks, so it's meant for short lines redrawn often.
+ */
+class GlyphLine {
+public:
+    static constexpr int MAX_GLYPHS = 32;
+
+    GlyphLine() = default;
+
+    GlyphLine(const GlyphLine &) = delete;
+
+    GlyphLine &operator=(const GlyphLine &) = delete;
+
+    ~GlyphLine() {
+        clear();
+    }
+
+    /**
+     * Centred on x like the text generator's center alignment
+     */
+    void set(GlyphAtlas &atlas, bn::fixed x, bn::fixed y, const bn::string_view &text);
+
+    void clear();
+
+private:
+    GlyphAtlas *atlas = nullptr;
+    bn::vector<bn::sprite_ptr, MAX_GLYPHS> sprites;
+    bn::vector<char, MAX_GLYPHS> glyphs;
+};
@@ -0,0 +1,25 @@
+#include "GpioWave.h"
+
+#ifdef LUCKY_DMA_GPIO
+
+#define GPIO_DAT *((volatile unsigned short *)0x080000C4)
+
+namespace GpioWave {
+    void sendCommandIwram(int command) {
+        for (int bit = 7; bit >= 0; bit--) {
+            unsigned short value = ((command >> bit) & 1) << 1 | 0b100;
+            for (int i = 0; i < COMMAND_WRITES_PER_BIT - 1; i++) GPIO_DAT = value;
+            GPIO_DAT = value | 0b001;
+        }
+    }
+
+    void sendByteIwram(int byte) {
+        for (int bit = 0; bit < 8; bit++) {
+            unsigned short value = ((byte >> bit) & 1) << 1 | 0b100;
+            for (int i = 0; i < DATA_WRITES_PER_BIT - 1; i++) GPIO_DAT = value;
+            GPIO_DAT = value | 0b001;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,32 @@
+#include "GpioWave.h"
+
+#ifdef LUCKY_DMA_GPIO
+
+#include "tonc.h"
+
+#define GPIO_DAT ((volatile unsigned short *)0x080000C4)
+
+namespace GpioWave {
+    static void replay(const unsigned short *waveform, int halfwords) {
+        // Nothing else may touch DMA3 between programming it and the kick
+        unsigned short savedImeValue = REG_IME;
+        REG_IME = 0;
+        REG_DMA3SAD = reinterpret_cast<unsigned>(waveform);
+        REG_DMA3DAD = reinterpret_cast<unsigned>(GPIO_DAT);
+        REG_DMA3CNT = DMA_ENABLE | DMA_16 | DMA_DST_FIXED | halfwords;
+        while (REG_DMA3CNT & DMA_ENABLE) {}
+        REG_IME = savedImeValue;
+    }
+
+    void sendCommandDma(int command) {
+        replay(tables.command[(command >> 4) & 0xF], 4 * COMMAND_WRITES_PER_BIT);
+        replay(tables.command[command & 0xF], 4 * COMMAND_WRITES_PER_BIT);
+    }
+
+    void sendByteDma(int byte) {
+        replay(tables.data[byte & 0xF], 4 * DATA_WRITES_PER_BIT);
+        replay(tables.data[(byte >> 4) & 0xF], 4 * DATA_WRITES_PER_BIT);
+    }
+}
+
+#endif
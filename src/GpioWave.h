@@ -0,0 +1,72 @@
+#pragma once
+
+/**
+ * Pre-computed REG_DAT waveforms for RTC command and data bytes, replayed into the GPIO port by DMA3.
+ * Tables are per nibble (two DMA kicks a byte) rather than per byte, which keeps them under 1.2 KiB of the
+ * multiboot image. Reads still go through the CPU loop, the chip only drives SIO between our clock edges.
+ * Opt-in (make DMAGPIO=1): a DMA burst clocks the chip faster than the CPU loop does, so check a cart with the
+ * soak test before trusting it.
+ */
+#ifdef LUCKY_DMA_GPIO
+
+#ifdef LUCKY_BUS_TRACE
+#error "DMA writes bypass the bus trace, build with DMAGPIO or TRACE but not both"
+#endif
+
+#include "bn_common.h"
+
+namespace GpioWave {
+    enum class Path : unsigned char {
+        Cpu, Iwram, Dma
+    };
+
+    // Same knocks as the CPU loops in RtcSceneManager: two holds then the clock edge for a command bit,
+    // five holds then the edge for a data bit
+    constexpr int COMMAND_WRITES_PER_BIT = 3;
+    constexpr int DATA_WRITES_PER_BIT = 6;
+
+    struct Tables {
+        // Command bytes go out MSB first, high nibble first
+        unsigned short command[16][4 * COMMAND_WRITES_PER_BIT];
+        // Data bytes go out LSB first, low nibble first
+        unsigned short data[16][4 * DATA_WRITES_PER_BIT];
+    };
+
+    constexpr Tables buildTables() {
+        Tables tables{};
+        for (int nibble = 0; nibble < 16; nibble++) {
+            int index = 0;
+            for (int bit = 3; bit >= 0; bit--) {
+                // SIO carries the bit, CS stays high, SCK rises on the last write
+                auto value = static_cast<unsigned short>(((nibble >> bit) & 1) << 1 | 0b100);
+                for (int i = 0; i < COMMAND_WRITES_PER_BIT - 1; i++) tables.command[nibble][index++] = value;
+                tables.command[nibble][index++] = value | 0b001;
+            }
+            index = 0;
+            for (int bit = 0; bit < 4; bit++) {
+                auto value = static_cast<unsigned short>(((nibble >> bit) & 1) << 1 | 0b100);
+                for (int i = 0; i < DATA_WRITES_PER_BIT - 1; i++) tables.data[nibble][index++] = value;
+                tables.data[nibble][index++] = value | 0b001;
+            }
+        }
+        return tables;
+    }
+
+    inline constexpr Tables tables = buildTables();
+
+    static_assert(tables.command[0x6][2] == 0b101 && tables.command[0x6][5] == 0b111, "MSB first, clocked high");
+    static_assert(tables.data[0x1][5] == 0b111 && tables.data[0x1][11] == 0b101, "LSB first, clocked high");
+
+    void sendCommandDma(int command);
+
+    void sendByteDma(int byte);
+
+    /**
+     * The CPU loops again, but running from IWRAM instead of the multiboot image in EWRAM
+     */
+    BN_CODE_IWRAM void sendCommandIwram(int command);
+
+    BN_CODE_IWRAM void sendByteIwram(int byte);
+}
+
+#endif
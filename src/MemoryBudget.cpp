@@ -0,0 +1,89 @@
+#include "MemoryBudget.h"
+
+#ifdef LUCKY_PROFILE
+
+#include "bn_log.h"
+#include "bn_memory.h"
+#include "bn_string_view.h"
+
+#define IWRAM_START 0x03000000
+#define STACK_PAINT 0x5AFEC0DE
+// Left alone on both ends, statics may end mid word and the painter's own frame is live
+#define GUARD_BYTES 64
+
+namespace MemoryBudget {
+    struct SceneUsage {
+        const char *name;
+        int heapPeak;
+        int stackPeak;
+    };
+
+    static constexpr int MAX_SCENES = 12;
+
+    static SceneUsage scenes[MAX_SCENES];
+    static int sceneCount = 0;
+    static const char *currentScene = "";
+    static int visitHeapPeak = 0;
+    static int overallHeapPeak = 0;
+    static unsigned *paintBottom = nullptr;
+    static unsigned stackTop = 0;
+
+    [[gnu::noinline]] static void paintBelowHere() {
+        volatile unsigned marker = 0;
+        auto *end = reinterpret_cast<unsigned *>((reinterpret_cast<unsigned>(&marker) - GUARD_BYTES) & ~3u);
+        for (volatile unsigned *word = paintBottom; word < end; ++word) *word = STACK_PAINT;
+    }
+
+    static SceneUsage &usageFor(const char *scene) {
+        for (int i = 0; i < sceneCount; i++) {
+            if (bn::string_view(scenes[i].name) == bn::string_view(scene)) return scenes[i];
+        }
+        // Out of slots, fold the rest into the last one rather than drop them
+        if (sceneCount == MAX_SCENES) return scenes[MAX_SCENES - 1];
+        scenes[sceneCount] = {scene, 0, 0};
+        return scenes[sceneCount++];
+    }
+
+    void init() {
+        volatile unsigned marker = 0;
+        unsigned sp = reinterpret_cast<unsigned>(&marker);
+        stackTop = sp + bn::memory::used_stack_iwram();
+        unsigned bottom = (IWRAM_START + bn::memory::used_static_iwram() + GUARD_BYTES + 3) & ~3u;
+        paintBottom = reinterpret_cast<unsigned *>(bottom);
+        paintBelowHere();
+    }
+
+    int stackPeak() {
+        auto *end = reinterpret_cast<unsigned *>(stackTop);
+        const volatile unsigned *word = paintBottom;
+        while (word < end && *word == STACK_PAINT) ++word;
+        return static_cast<int>(stackTop - reinterpret_cast<unsigned>(word));
+    }
+
+    void frame(const char *scene) {
+        int heap = bn::memory::used_alloc_ewram();
+        if (heap > overallHeapPeak) overallHeapPeak = heap;
+
+        if (bn::string_view(scene) != bn::string_view(currentScene)) {
+            if (*currentScene) {
+                int stack = stackPeak();
+                SceneUsage &usage = usageFor(currentScene);
+                if (visitHeapPeak > usage.heapPeak) usage.heapPeak = visitHeapPeak;
+                if (stack > usage.stackPeak) usage.stackPeak = stack;
+                BN_LOG("MEM,scene,", currentScene, ",heap=", visitHeapPeak, ",stack=", stack,
+                       ",worst_heap=", usage.heapPeak, ",worst_stack=", usage.stackPeak);
+                BN_LOG("MEM,budget,iwram_static=", bn::memory::used_static_iwram(),
+                       ",stack_free=", static_cast<int>(stackTop - reinterpret_cast<unsigned>(paintBottom)) - stack,
+                       ",ewram_static=", bn::memory::used_static_ewram(), ",heap_peak=", overallHeapPeak,
+                       ",heap_free=", bn::memory::available_alloc_ewram());
+                // Fresh paint so the next scene's peak is its own
+                paintBelowHere();
+            }
+            currentScene = scene;
+            visitHeapPeak = heap;
+        }
+        if (heap > visitHeapPeak) visitHeapPeak = heap;
+    }
+}
+
+#endif
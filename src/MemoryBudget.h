@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * Runtime memory headroom for profile builds: paints the free IWRAM below the stack at boot and
+ * scans it back for a high-water mark, and samples the EWRAM heap every frame.
+ * Each scene visit logs its own stack and heap peaks followed by an overall budget line.
+ */
+#ifdef LUCKY_PROFILE
+
+namespace MemoryBudget {
+    /**
+     * Call as early as possible from main, everything below the caller's frame is painted
+     */
+    void init();
+
+    /**
+     * Call once per frame after the scenes have updated
+     */
+    void frame(const char *scene);
+
+    /**
+     * Deepest the stack has been since the last repaint, in bytes
+     */
+    int stackPeak();
+}
+
+#define MEMORY_INIT() MemoryBudget::init()
+#define MEMORY_FRAME(scene) MemoryBudget::frame(scene)
+
+#else
+
+#define MEMORY_INIT()
+#define MEMORY_FRAME(scene)
+
+#endif
@@ -0,0 +1,68 @@
+#include "PerfHud.h"
+
+#include "bn_core.h"
+#include "bn_memory.h"
+#include "bn_sprite_tiles.h"
+#include "bn_sprites.h"
+#include "bn_string.h"
+
+#include "common_variable_8x8_sprite_font.h"
+
+#include "MemoryBudget.h"
+
+// Centres of the strips outside the scenes' rows, which span -72 to +72
+#define TOP_ROW_Y (-76)
+#define BOTTOM_ROW_Y 76
+
+PerfHud::PerfHud() : generator(common::variable_8x8_sprite_font) {
+    generator.set_center_alignment();
+}
+
+void PerfHud::toggle() {
+    shown = !shown;
+    sprites.clear();
+    refreshFrames = 0;
+#ifdef LUCKY_PROFILE
+    if (shown) stackBytes = MemoryBudget::stackPeak();
+#endif
+}
+
+void PerfHud::update(const char *scene, unsigned busTransactions, unsigned busBits) {
+    // Bus rates are tracked even while hidden so the first readout is already a full second
+    if (++busFrames >= BUS_WINDOW_FRAMES) {
+        lastTransactionsPerSecond = busTransactions - windowTransactions;
+        lastBitsPerSecond = busBits - windowBits;
+        windowTransactions = busTransactions;
+        windowBits = busBits;
+        busFrames = 0;
+#ifdef LUCKY_PROFILE
+        if (shown) stackBytes = MemoryBudget::stackPeak();
+#endif
+    }
+    if (!shown || --refreshFrames > 0) return;
+    refreshFrames = REFRESH_FRAMES;
+
+    bn::string<64> usage = "CPU ";
+    usage += bn::to_string<8>((bn::core::last_cpu_usage() * 100).integer());
+    usage += "% SPR ";
+    usage += bn::to_string<8>(bn::sprites::used_items_count());
+    usage += " TIL ";
+    usage += bn::to_string<8>(bn::sprite_tiles::used_tiles_count());
+    usage += " HEAP ";
+    usage += bn::to_string<8>(bn::memory::used_alloc_ewram());
+#ifdef LUCKY_PROFILE
+    usage += " STK ";
+    usage += bn::to_string<8>(stackBytes);
+#endif
+
+    bn::string<64> bus = "RTC ";
+    bus += bn::to_string<8>(lastTransactionsPerSecond);
+    bus += " tx/s ";
+    bus += bn::to_string<8>(lastBitsPerSecond);
+    bus += " bit/s ";
+    bus += scene;
+
+    sprites.clear();
+    generator.generate(0, TOP_ROW_Y, usage, sprites);
+    generator.generate(0, BOTTOM_ROW_Y, bus, sprites);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "bn_sprite_ptr.h"
+#include "bn_sprite_text_generator.h"
+#include "bn_vector.h"
+
+/**
+ * Debug overlay with live frame cost, sprite/tile/heap usage, RTC bus traffic and the active scene.
+ * Text is only regenerated twice a second so the overlay barely shows up in what it measures.
+ * Drawn in the 8 pixel strips above and below the scenes' nine 16 pixel rows, so nothing on screen gets covered.
+ */
+class PerfHud {
+public:
+    PerfHud();
+
+    void toggle();
+
+    [[nodiscard]] bool visible() const {
+        return shown;
+    }
+
+    /**
+     * Call once per frame with the running bus counters, cheap when hidden
+     */
+    void update(const char *scene, unsigned busTransactions, unsigned busBits);
+
+private:
+    static constexpr int REFRESH_FRAMES = 30;
+    static constexpr int BUS_WINDOW_FRAMES = 60;
+
+    bool shown = false;
+    int refreshFrames = 0;
+    int busFrames = 0;
+    unsigned windowTransactions = 0;
+    unsigned windowBits = 0;
+    unsigned lastTransactionsPerSecond = 0;
+    unsigned lastBitsPerSecond = 0;
+    // Scanning the painted stack walks most of IWRAM, so it is only redone once a second
+    int stackBytes = 0;
+    bn::sprite_text_generator generator;
+    bn::vector<bn::sprite_ptr, 24> sprites;
+};
@@ -0,0 +1,67 @@
+#include "Profiler.h"
+
+#ifdef LUCKY_PROFILE
+
+#include "bn_log.h"
+
+// Frames between dumps to the log
+#define PROFILE_REPORT_FRAMES 120
+
+namespace Profiler {
+    struct Stats {
+        unsigned count;
+        unsigned min;
+        unsigned max;
+        unsigned long long total;
+    };
+
+    static constexpr const char *scopeNames[SCOPE_COUNT] = {
+            "transitions",
+            "scene updates",
+            "cart poll",
+            "readStatus",
+            "writeStatus",
+            "setRTC",
+            "resetChip",
+            "text generate",
+    };
+
+    static Stats stats[SCOPE_COUNT];
+    static int frames = 0;
+
+    static void reset() {
+        for (Stats &scopeStats: stats) scopeStats = {0, ~0u, 0, 0};
+    }
+
+    void init() {
+        CycleCounter::start();
+        reset();
+    }
+
+    void record(Scope scope, unsigned cycles) {
+        Stats &scopeStats = stats[scope];
+        scopeStats.count++;
+        scopeStats.total += cycles;
+        if (cycles < scopeStats.min) scopeStats.min = cycles;
+        if (cycles > scopeStats.max) scopeStats.max = cycles;
+    }
+
+    void endFrame() {
+        if (++frames < PROFILE_REPORT_FRAMES) return;
+        flush();
+    }
+
+    void flush() {
+        frames = 0;
+        for (int i = 0; i < SCOPE_COUNT; i++) {
+            const Stats &scopeStats = stats[i];
+            if (!scopeStats.count) continue;
+            BN_LOG("PROF ", scopeNames[i], " n=", scopeStats.count, " min=", scopeStats.min,
+                   " avg=", static_cast<unsigned>(scopeStats.total / scopeStats.count), " max=", scopeStats.max,
+                   " sum=", static_cast<unsigned>(scopeStats.total));
+        }
+        reset();
+    }
+}
+
+#endif
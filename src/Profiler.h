@@ -0,0 +1,68 @@
+#pragma once
+
+/**
+ * Scoped cycle profiler, aggregates min/avg/max per scope and dumps them to the mGBA log.
+ * Only exists in profile builds (make PROFILE=1), everything below compiles to nothing otherwise.
+ */
+namespace Profiler {
+    enum Scope : unsigned char {
+        STATE_TRANSITIONS,
+        SCENE_UPDATES,
+        CART_POLL,
+        RTC_READ_STATUS,
+        RTC_WRITE_STATUS,
+        RTC_SET,
+        RTC_RESET,
+        TEXT_GENERATE,
+        SCOPE_COUNT
+    };
+}
+
+#ifdef LUCKY_PROFILE
+
+#include "CycleCounter.h"
+
+namespace Profiler {
+    void init();
+
+    void record(Scope scope, unsigned cycles);
+
+    /**
+     * Call once per frame, dumps and resets the aggregates every couple of seconds
+     */
+    void endFrame();
+
+    /**
+     * Dumps and resets the aggregates now, so a window can be closed at a point of interest
+     */
+    void flush();
+
+    class Marker {
+    public:
+        explicit Marker(Scope scope) : scope(scope), start(CycleCounter::now()) {}
+
+        ~Marker() {
+            record(scope, CycleCounter::now() - start);
+        }
+
+    private:
+        Scope scope;
+        unsigned start;
+    };
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_INIT() Profiler::init()
+#define PROFILE_SCOPE(scope) Profiler::Marker PROFILE_CONCAT(profileMarker, __LINE__)(Profiler::scope)
+#define PROFILE_FRAME() Profiler::endFrame()
+#define PROFILE_FLUSH() Profiler::flush()
+
+#else
+
+#define PROFILE_INIT()
+#define PROFILE_SCOPE(scope)
+#define PROFILE_FRAME()
+#define PROFILE_FLUSH()
+
+#endif
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "bn_string.h"
+#include "bn_string_view.h"
+
+/**
+ * Calendar and text formatting helpers with no hardware behind them.
+ * Kept free of anything GBA specific so they also build natively, see tools/host.
+ */
+namespace RtcFormat {
+    inline constexpr bn::string_view week_days[] = {
+            "Sunday",
+            "Monday",
+            "Tuesday",
+            "Wednesday",
+            "Thursday",
+            "Friday",
+            "Saturday",
+    };
+
+    /**
+     * LUT for fast binary to BCD conversion
+     * Credit: Gericom
+     */
+    inline int toBcd(unsigned int value) {
+        static const unsigned char sToBcd[100] =
+                {
+                        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+                        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19,
+                        0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29,
+                        0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+                        0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+                        0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59,
+                        0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+                        0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79,
+                        0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+                        0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99
+                };
+
+        return sToBcd[value];
+    }
+
+    /**
+     * Appends the low byte of a BCD field as two digits
+     */
+    template<int MaxSize>
+    void appendBcd(bn::string<MaxSize> &text, unsigned bcd) {
+        text += static_cast<char>('0' + ((bcd >> 4) & 0xF));
+        text += static_cast<char>('0' + (bcd & 0xF));
+    }
+
+    inline bn::string<64> &appendTime(bn::string<64> &text, int hours, int minutes, int seconds, bool twelveHourMode) {
+        int stagingHour = hours;
+        if (twelveHourMode) {
+            stagingHour %= 12;
+            if (stagingHour == 0)
+                stagingHour = 12;
+        }
+        bn::string<4> hour = bn::to_string<4>(stagingHour);
+        bn::string<4> minute = bn::to_string<4>(minutes);
+        bn::string<4> second = bn::to_string<4>(seconds);
+
+        if (hour.size() == 1) {
+            hour = "0" + hour;
+        }
+
+        if (minute.size() == 1) {
+            minute = "0" + minute;
+        }
+
+        if (second.size() == 1) {
+            second = "0" + second;
+        }
+
+        text += " ";
+        text += hour;
+        text += ':';
+        text += minute;
+        text += ':';
+        text += second;
+        if (twelveHourMode) {
+            text += " ";
+            text += hours >= 12 ? "PM" : "AM";
+        }
+        return text;
+    }
+
+    /**
+     * Appends a value held in tenths as a decimal, e.g. -123 as "-12.3"
+     */
+    template<int MaxSize>
+    void appendTenths(bn::string<MaxSize> &text, int tenths, bool showPlus) {
+        if (tenths < 0) {
+            text += '-';
+            tenths = -tenths;
+        } else if (showPlus) {
+            text += '+';
+        }
+        text += bn::to_string<10>(tenths / 10);
+        text += '.';
+        text += static_cast<char>('0' + tenths % 10);
+    }
+
+    /**
+     * Inverse of toBcd for a single BCD byte
+     */
+    inline int fromBcd(unsigned bcd) {
+        return static_cast<int>((bcd >> 4 & 0xF) * 10 + (bcd & 0xF));
+    }
+
+    /**
+     * Calendar fields as the chip holds them: two digit year, 24 hour clock, week day 0-6
+     */
+    struct DateTime {
+        int year = 0, month = 1, day = 1, weekDay = 0, hour = 0, minute = 0, second = 0;
+
+        bool operator==(const DateTime &other) const = default;
+    };
+
+    /**
+     * Unpacks the seven BCD bytes of a datetime read, folding the PM flag into the hour in 12 hour mode
+     */
+    inline DateTime decodeDateTime(const unsigned char *bcd, bool twelveHourMode) {
+        DateTime dateTime;
+        dateTime.year = fromBcd(bcd[0]);
+        dateTime.month = fromBcd(bcd[1] & 0x1F);
+        dateTime.day = fromBcd(bcd[2] & 0x3F);
+        dateTime.weekDay = bcd[3] & 0x07;
+        dateTime.hour = fromBcd(bcd[4] & 0x3F);
+        if (twelveHourMode && bcd[4] & 0x80) dateTime.hour += 12;
+        dateTime.minute = fromBcd(bcd[5] & 0x7F);
+        dateTime.second = fromBcd(bcd[6] & 0x7F);
+        return dateTime;
+    }
+
+    [[nodiscard]] inline int daysInMonth(int year, int month) {
+        static constexpr int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        // Two digit years, 00 is 2000 and so a leap year
+        if (month == 2 && year % 4 == 0) return 29;
+        return days[(month - 1) % 12];
+    }
+
+    /**
+     * Moves the clock forward, rolling over the same way the chip does (99 wraps to 00)
+     */
+    inline void addSeconds(DateTime &dateTime, unsigned seconds) {
+        unsigned total = dateTime.second + seconds;
+        dateTime.second = static_cast<int>(total % 60);
+        total = dateTime.minute + total / 60;
+        dateTime.minute = static_cast<int>(total % 60);
+        total = dateTime.hour + total / 60;
+        dateTime.hour = static_cast<int>(total % 24);
+        for (unsigned days = total / 24; days > 0; days--) {
+            dateTime.weekDay = (dateTime.weekDay + 1) % 7;
+            if (++dateTime.day <= daysInMonth(dateTime.year, dateTime.month)) continue;
+            dateTime.day = 1;
+            if (++dateTime.month <= 12) continue;
+            dateTime.month = 1;
+            dateTime.year = (dateTime.year + 1) % 100;
+        }
+    }
+
+// Zeller's Congruence algorithm
+    [[nodiscard]] inline int calculateDayOfWeekIndex(int year, int month, int day) {
+        static constexpr int t[] = {0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4};
+        int y = year;
+
+        if (month < 3) {
+            y--;
+        }
+
+        // 100 and 400 div maybe not necessary...
+        return (y + y / 4 - y / 100 + y / 400 + t[month - 1] + day) % 7;
+    }
+
+    inline bn::string<64> &appendDate(bn::string<64> &text, int year, int month, int day, int weekDay) {
+        text += week_days[calculateDayOfWeekIndex(year, month, day)];
+        text += "(";
+        text += bn::to_string<1>(weekDay);
+        text += ")";
+        text += ' ';
+        text += bn::to_string<4>(year);
+        text += '/';
+        text += bn::to_string<4>(month);
+        text += '/';
+        text += bn::to_string<4>(day);
+        return text;
+    }
+}
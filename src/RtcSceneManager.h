@@ -16,54 +16,196 @@
 #include "bn_sprite_items_error.h"
 
 #include "TimeFormatter.h"
+#include "RtcFormat.h"
+#include "CartMonitor.h"
+#include "GameDatabase.h"
+#include "CartCache.h"
+#include "DriftMeter.h"
+#include "SoakTest.h"
+#include "SoftClock.h"
+#include "BackupBench.h"
+#include "WaitTuner.h"
+#include "GpioWave.h"
+#include "SolarSensor.h"
+#include "TestReport.h"
+#include "Task.h"
+
+#include "CycleCounter.h"
+#include "Profiler.h"
+#include "PerfHud.h"
+#include "TextQueue.h"
+#include "GlyphAtlas.h"
+#include "BenchLog.h"
+#include "BusTrace.h"
+#include "MemoryBudget.h"
 
 #include "hsm.h"
 
 using namespace hsm;
 
+#ifdef LUCKY_BUS_TRACE
+#define REG_DAT BusTrace::Port<BusTrace::DAT>()
+#define REG_DIR BusTrace::Port<BusTrace::DIR>()
+#define REG_CTL BusTrace::Port<BusTrace::CTL>()
+#else
 #define REG_DAT *((volatile uint16_t *)0x080000C4)
 #define REG_DIR *((volatile uint16_t *)0x080000C6)
 #define REG_CTL *((volatile uint16_t *)0x080000C8)
-#define REG_NAM ((volatile uint16_t *)0x080000A0)
+#endif
 
 // We mask 0x60 here and/or add 1 to the LSB to indicate R/W intent
 #define MASK_READ(x) (((x)<<1) | 0x61)
 #define MASK_WRITE(x) (((x)<<1) | 0x60)
 
-static constexpr bn::string_view week_days[] = {
-        "Sunday",
-        "Monday",
-        "Tuesday",
-        "Wednesday",
-        "Thursday",
-        "Friday",
-        "Saturday",
-};
-
 class RtcSceneManager {
 public:
     explicit RtcSceneManager(bn::sprite_text_generator generator, bn::optional<bn::sprite_ptr> statusSprite);
 
     void Update() {
-        sm.ProcessStateTransitions();
-        sm.UpdateStates();
+#ifdef LUCKY_BENCH
+        const char *sceneBefore = sm.IsStarted() ? sceneName() : "";
+        unsigned transitionStart = CycleCounter::now();
+#endif
+        {
+            PROFILE_SCOPE(STATE_TRANSITIONS);
+            sm.ProcessStateTransitions();
+        }
+        BENCH_FRAME(sceneBefore, sceneName(), CycleCounter::now() - transitionStart);
+        {
+            PROFILE_SCOPE(SCENE_UPDATES);
+            sm.UpdateStates();
+        }
+        {
+            PROFILE_SCOPE(TEXT_GENERATE);
+#ifdef LUCKY_BENCH
+            unsigned textStart = CycleCounter::now();
+#endif
+            [[maybe_unused]] int lines = textQueue.drain(textGenerator, TEXT_BUDGET_CYCLES);
+            BENCH_TEXT(sceneName(), lines, CycleCounter::now() - textStart, !textQueue.empty());
+        }
+        MEMORY_FRAME(sceneName());
+
+        // Hidden combo: hold L, press B
+        if (bn::keypad::l_held() && bn::keypad::b_pressed()) perfHud.toggle();
+#ifdef LUCKY_BUS_TRACE
+        // Long hold rather than a press so no scene's own buttons fire along with it
+        if (bn::keypad::l_held() && bn::keypad::r_held()) {
+            if (++traceHoldFrames == BusTrace::EXPORT_HOLD_FRAMES) BusTrace::exportToLog();
+        } else {
+            traceHoldFrames = 0;
+        }
+#endif
+        perfHud.update(sceneName(), busTransactions, busBits);
+    }
+
+    /**
+     * How many frames the cart monitor state waits between polls of the slot.
+     */
+    void setCartPollInterval(int frames) {
+        cartPollInterval = frames > 0 ? frames : 1;
+    }
+
+    /**
+     * Keeps the cart monitor off the bus while the cart mapping is being probed, re-reads it once released.
+     */
+    void holdCartMonitor(bool held) {
+        cartMonitor.setHeld(held);
+        if (!held) cartMonitor.invalidate();
     }
 
 private:
+    // Share of each frame queued text may use, one line always goes out regardless
+    static constexpr unsigned TEXT_BUDGET_CYCLES = 280896 / 8;
+
+    // Ahead of the state machine so it outlives every scene's glyph lines
+    GlyphAtlas glyphAtlas{common::variable_8x16_sprite_font};
     StateMachine sm;
     bn::sprite_text_generator textGenerator;
+    TextQueue textQueue;
     bn::optional<bn::sprite_ptr> statusSprite;
+    CartMonitor cartMonitor;
+    int cartPollInterval = 1;
+    PerfHud perfHud;
+#ifdef LUCKY_BUS_TRACE
+    int traceHoldFrames = 0;
+#endif
+
+    // Running RTC bus counters, read by the perf HUD
+    static inline unsigned busTransactions = 0;
+    static inline unsigned busBits = 0;
+
+#ifdef LUCKY_DMA_GPIO
+    // What drives command and data bytes onto the port, switchable for comparisons
+    static inline GpioWave::Path busPath = GpioWave::Path::Dma;
+#endif
 
     friend struct ClientStates;
     unsigned short rtcStatus = 0;
     bool rtcFail = false;
-    bn::string<12> lastSeenGameCode;
+    unsigned handledCartGeneration = 0;
+    const GameDatabase::GameInfo *knownGame = nullptr;
+    bool cacheHit = false;
+    bool cacheConfirmed = false;
+    CartCache::Entry cachedEntry{};
+
+    const char *sceneName() {
+        return (*sm.BeginInnerToOuter())->GetStateDebugName();
+    }
+
+    void generateText(bn::fixed x, bn::fixed y, const bn::string_view &text, bn::ivector<bn::sprite_ptr> &sprites) {
+        PROFILE_SCOPE(TEXT_GENERATE);
+        textGenerator.generate(x, y, text, sprites);
+    }
+
+    /**
+     * Like generateText, but drawn over the next frames so entering a scene doesn't spike
+     */
+    void queueText(bn::fixed x, bn::fixed y, const bn::string_view &text, bn::ivector<bn::sprite_ptr> &sprites,
+                   TextQueue::Priority priority = TextQueue::Priority::Normal) {
+        if (!textQueue.push(x, y, text, sprites, priority)) generateText(x, y, text, sprites);
+    }
+
+    /**
+     * Clears sprites along with any of their lines still waiting in the queue
+     */
+    void clearText(bn::ivector<bn::sprite_ptr> &sprites) {
+        textQueue.discard(sprites);
+        sprites.clear();
+    }
+
+    /**
+     * Status icon in the corner, shared by every scene
+     */
+    void showPresence(CartCache::Presence presence) {
+        const int x = -108, y = -64;
+        switch (presence) {
+            case CartCache::Presence::Missing:
+                statusSprite = bn::sprite_items::missing.create_sprite_optional(x, y);
+                break;
+            case CartCache::Presence::Dead:
+                statusSprite = bn::sprite_items::dead.create_sprite_optional(x, y);
+                break;
+            case CartCache::Presence::Full:
+                statusSprite = bn::sprite_items::full.create_sprite_optional(x, y);
+                break;
+            case CartCache::Presence::Error:
+                statusSprite = bn::sprite_items::error.create_sprite_optional(x, y);
+                break;
+        }
+    }
 
     /**
      * Will set up the RTC module to read or write from other methods.
      * See the data sheet for the Seiko S-3511 for more details.
      */
     static void commandRTC(int command) {
+        // Every transaction opens with a command byte
+        busTransactions++;
+        busBits += 8;
+#ifdef LUCKY_DMA_GPIO
+        if (busPath == GpioWave::Path::Dma) return GpioWave::sendCommandDma(command);
+        if (busPath == GpioWave::Path::Iwram) return GpioWave::sendCommandIwram(command);
+#endif
         // Shift command up to avoid collision with LSB R/W bit
         command <<= 1;
         // Read the 8 bits in MSB->LSB order
@@ -86,6 +228,7 @@ private:
      * Assuming proper signaling to the RTC module prior, will read out 8 bits from the module
      */
     static int readByte() {
+        busBits += 8;
         int data = 0; // store data somewhere
         // Read 8 bits
         for (int bit = 0; bit < 8; bit++) {
@@ -107,6 +250,11 @@ private:
      * Assuming proper signaling to the RTC module prior, will write out 8 bits to the module
      */
     static void writeByte(int byte) {
+        busBits += 8;
+#ifdef LUCKY_DMA_GPIO
+        if (busPath == GpioWave::Path::Dma) return GpioWave::sendByteDma(byte);
+        if (busPath == GpioWave::Path::Iwram) return GpioWave::sendByteIwram(byte);
+#endif
         // Shift command up to avoid collision with LSB R/W bit
         byte <<= 1;
         // Write the 8 bits in LSB->MSB order
@@ -128,6 +276,7 @@ private:
      * Handles own signaling, commits full date and time to module
      */
     static void setRTC(int year, int month, int day, int dayOfWeek, int hour, int minute, int second, bool afternoon) {
+        PROFILE_SCOPE(RTC_SET);
         int i;
         unsigned char dataField[7]{static_cast<unsigned char>(year), static_cast<unsigned char>(month),
                                    static_cast<unsigned char>(day), static_cast<unsigned char>(dayOfWeek),
@@ -161,6 +310,7 @@ private:
     }
 
     static int readStatus() {
+        PROFILE_SCOPE(RTC_READ_STATUS);
         // We want to init the RTC without resetting it automatically, so skip butano and agbabi methods
         REG_CTL = 0b001; // enable control of remote chip
         // Most get this wrong and send dir first, but real games do the below
@@ -177,7 +327,50 @@ private:
         return checkValue;
     }
 
+    /**
+     * Reads hour, minute and second (packed low to high, BCD) without touching the date
+     */
+    static int readTime() {
+        REG_CTL = 0b001;
+        REG_DAT = 0b001;
+        REG_DAT = 0b101;
+        REG_DIR = 0b111;
+        // Time only is read command 3
+        commandRTC(MASK_READ(3));
+        REG_DIR = 0b101;
+        int hour = readByte();
+        int minute = readByte();
+        int second = readByte();
+        return hour | minute << 8 | second << 16;
+    }
+
+    /**
+     * Reads the full datetime as the seven raw BCD bytes, year first
+     */
+    static void readDateTime(unsigned char *bcd) {
+        REG_CTL = 0b001;
+        REG_DAT = 0b001;
+        REG_DAT = 0b101;
+        REG_DIR = 0b111;
+        // Full datetime is read command 2
+        commandRTC(MASK_READ(2));
+        REG_DIR = 0b101;
+        for (int i = 0; i < 7; i++) {
+            bcd[i] = static_cast<unsigned char>(readByte());
+        }
+    }
+
+    /**
+     * Writes a 24 hour datetime in whichever hour mode the chip is in
+     */
+    static void writeDateTime(const RtcFormat::DateTime &dateTime, bool twelveHourMode) {
+        setRTC(dateTime.year, dateTime.month, dateTime.day, dateTime.weekDay,
+               twelveHourMode ? dateTime.hour % 12 : dateTime.hour, dateTime.minute, dateTime.second,
+               dateTime.hour >= 12);
+    }
+
     static void writeStatus(unsigned short status) {
+        PROFILE_SCOPE(RTC_WRITE_STATUS);
         // Enable control
         REG_CTL = 0b001;
         // Knock data pins 1 and 3
@@ -194,6 +387,7 @@ private:
      * Handles own signaling, sends factory init signal to module
      */
     static void resetChip() {
+        PROFILE_SCOPE(RTC_RESET);
         // Wake up
         REG_DAT = 0b001;
         // Raise signal
@@ -206,138 +400,25 @@ private:
         REG_DAT = 0b001;
     }
 
-    /**
-     * LUT for fast binary to BCD conversion
-     * Credit: Gericom
-     */
     static int toBcd(unsigned int value) {
-        static const unsigned char sToBcd[100] =
-                {
-                        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
-                        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19,
-                        0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29,
-                        0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
-                        0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
-                        0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59,
-                        0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
-                        0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79,
-                        0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
-                        0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99
-                };
-
-        return sToBcd[value];
-    }
-
-    static bool isPrintable(int c) {
-        return ' ' <= c && c <= '~';
-    }
-
-    static bn::vector<char, 12> &truncate_to_last_printable(bn::vector<char, 12> &vec) {
-        if (vec.empty()) {
-            return vec;
-        }
-
-        auto last_printable = vec.end();
-
-        for (auto it = vec.begin(); it != vec.end(); ++it) {
-            if (isPrintable(static_cast<unsigned char>(*it))) {
-                last_printable = it;
-            } else {
-                break;
-            }
-        }
-
-        if (last_printable != vec.end()) {
-            vec.erase(std::next(last_printable), vec.end());
-        } else {
-            vec.clear();
-        }
-
-        return vec;
-    }
-
-    static bn::string<12> getGameString() {
-        bn::vector<char, 12> gametitle;
-
-        for (int i = 0; i < 6; ++i) {
-            uint16_t word = *(REG_NAM + i);
-            gametitle.push_back(static_cast<char>(word & 0xFF));
-            gametitle.push_back(static_cast<char>((word >> 8) & 0xFF));
-        }
-
-        gametitle = truncate_to_last_printable(gametitle);
-
-        bn::string<12> result = "";
-        for (char c: gametitle) {
-            result += c;
-        }
-
-        return result;
+        return RtcFormat::toBcd(value);
     }
 
     static bn::string<64> &
     getTimeString(bn::string<64> &text, const bn::optional<bn::time> &time, bool twelveHourMode) {
-        int stagingHour = time->hour();
-        if (twelveHourMode) {
-            stagingHour %= 12;
-            if (stagingHour == 0)
-                stagingHour = 12;
-        }
-        bn::string<4> hour = bn::to_string<4>(stagingHour);
-        bn::string<4> minute = bn::to_string<4>(time->minute());
-        bn::string<4> second = bn::to_string<4>(time->second());
-
-        if (hour.size() == 1) {
-            hour = "0" + hour;
-        }
-
-        if (minute.size() == 1) {
-            minute = "0" + minute;
-        }
-
-        if (second.size() == 1) {
-            second = "0" + second;
-        }
+        return RtcFormat::appendTime(text, time->hour(), time->minute(), time->second(), twelveHourMode);
+    }
 
-        text += " ";
-        text += hour;
-        text += ':';
-        text += minute;
-        text += ':';
-        text += second;
-        if (twelveHourMode) {
-            text += " ";
-            text += time->hour() >= 12 ? "PM" : "AM";
-        }
-        return text;
-    };
+    static void appendBcd(bn::string<64> &text, unsigned bcd) {
+        RtcFormat::appendBcd(text, bcd);
+    }
 
-// Zeller's Congruence algorithm
     [[nodiscard]] static int calculateDayOfWeekIndex(int year, int month, int day) {
-        static constexpr int t[] = {0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4};
-        int y = year;
-
-        if (month < 3) {
-            y--;
-        }
-
-        // 100 and 400 div maybe not necessary...
-        return (y + y / 4 - y / 100 + y / 400 + t[month - 1] + day) % 7;
+        return RtcFormat::calculateDayOfWeekIndex(year, month, day);
     }
 
-
     static bn::string<64> &getDateString(bn::string<64> &text, const bn::optional<bn::date> &date) {
-        text += week_days[calculateDayOfWeekIndex(date->year(), date->month(), date->month_day())];
-        text += "(";
-        text += bn::to_string<1>(date->week_day());
-        text += ")";
-        text += ' ';
-        text += bn::to_string<4>(date->year());
-        text += '/';
-        text += bn::to_string<4>(date->month());
-        text += '/';
-        text += bn::to_string<4>(date->month_day());
-        return text;
+        return RtcFormat::appendDate(text, date->year(), date->month(), date->month_day(), date->week_day());
     }
 
 };
@@ -346,61 +427,129 @@ struct ClientStates {
     struct BaseState : StateWithOwner<RtcSceneManager> {
 
         BaseState() = default;
+    };
+
+    /**
+     * Outermost state, owns cart monitoring and the status sprite for every scene inside it.
+     * Polls the slot once per configured interval and publishes the result on the owner,
+     * the scenes only ever read what it left there.
+     */
+    struct CartMonitorState : BaseState {
+        int framesUntilPoll = 0;
+
+        Transition GetTransition() override {
+            return InnerEntryTransition<WelcomeScene>();
+        }
+
+        void Update() override {
+            if (--framesUntilPoll > 0) return;
+            framesUntilPoll = Owner().cartPollInterval;
+            PROFILE_SCOPE(CART_POLL);
+            Owner().cartMonitor.update();
+            pollStatusSprite();
+        }
 
         void pollStatusSprite() {
-            // If we've already checked this one don't re-check
-            if (Owner().lastSeenGameCode == RtcSceneManager::getGameString()) {
+            // Only re-check once the monitor has confirmed a swap
+            if (Owner().handledCartGeneration == Owner().cartMonitor.generation()) {
+                // Settle a cached result against the real chip, a frame after it went on screen
+                if (Owner().cacheHit && !Owner().cacheConfirmed) {
+                    Owner().cacheConfirmed = true;
+                    confirmStatus();
+                }
+                return;
+            }
+            Owner().handledCartGeneration = Owner().cartMonitor.generation();
+            Owner().knownGame = GameDatabase::lookup(Owner().cartMonitor.gameCode());
+            Owner().cacheHit = false;
+            // The bus is asked even for titles listed without an RTC: repros, modded and mislabelled carts have one
+            const CartCache::Entry *cached = CartCache::find(Owner().cartMonitor.signature(),
+                                                             Owner().cartMonitor.gameCode());
+            if (cached) {
+                Owner().cacheHit = true;
+                Owner().cacheConfirmed = false;
+                Owner().cachedEntry = *cached;
+                Owner().rtcStatus = cached->status;
+                Owner().rtcFail = cached->status & 0x80;
+                Owner().showPresence(cached->presence);
                 return;
             }
-            Owner().lastSeenGameCode = RtcSceneManager::getGameString();
+            confirmStatus();
+        }
+
+        void confirmStatus() {
             Owner().rtcStatus = RtcSceneManager::readStatus();
             Owner().rtcFail = Owner().rtcStatus & 0x80;
-            const int x = -108, y = -64;
+            CartCache::Presence presence;
+            unsigned lastSeenDate = 0, lastSeenTime = 0;
             if (Owner().rtcStatus == 0xFF) {
-                Owner().statusSprite = bn::sprite_items::missing.create_sprite_optional(x, y);
+                presence = CartCache::Presence::Missing;
             } else if (Owner().rtcStatus & 0x80 && Owner().rtcStatus != 0x82) {
-                Owner().statusSprite = bn::sprite_items::dead.create_sprite_optional(x, y);
-            } else if (Owner().rtcStatus == 0x82 || Owner().rtcStatus == 0x40) {
-                Owner().statusSprite = bn::sprite_items::full.create_sprite_optional(x, y);
+                presence = CartCache::Presence::Dead;
+            } else if (Owner().rtcStatus == 0x82) {
+                presence = CartCache::Presence::Full;
             } else {
-                // no status is suspicious
+                // no status is suspicious, and a healthy chip gives us a last-seen time either way
                 auto datetime = __agbabi_rtc_datetime();
+                lastSeenDate = datetime[0];
+                lastSeenTime = datetime[1];
                 // Check if date has any data (blank is a fault state)
-                if (!datetime[1]) {
-                    Owner().statusSprite = bn::sprite_items::error.create_sprite_optional(x, y);
-                    return;
-                }
-                Owner().statusSprite = bn::sprite_items::full.create_sprite_optional(x, y);
+                presence = Owner().rtcStatus == 0x40 || datetime[1] ? CartCache::Presence::Full
+                                                                    : CartCache::Presence::Error;
             }
+            Owner().showPresence(presence);
+            reportStatus(presence, lastSeenDate, lastSeenTime);
+            CartCache::store(Owner().cartMonitor.signature(), Owner().cartMonitor.gameCode(), Owner().rtcStatus,
+                             presence, lastSeenDate, lastSeenTime);
         }
+
+        void reportStatus(CartCache::Presence presence, unsigned date, unsigned time) {
+            if (!TestReport::claim(TestReport::KIND_STATUS, Owner().cartMonitor.generation())) return;
+            static constexpr const char *classes[] = {"missing", "dead", "ok", "error"};
+            TestReport::Line line("status", Owner().cartMonitor.gameCode());
+            line.hex("sig", Owner().cartMonitor.signature(), 4)
+                    .hex("status", Owner().rtcStatus, 2)
+                    .field("class", classes[static_cast<int>(presence)]);
+            if (Owner().knownGame) {
+                line.field("title", Owner().knownGame->name);
+                if (Owner().knownGame->rtc == GameDatabase::RtcChip::None) line.field("listed_rtc", "none");
+            }
+            if (date) line.bcd("date", date, 3, '-', "20");
+            // Hour carries the PM flag up top
+            if (time) line.bcd("time", time & 0xFFFF3F, 3, ':', "");
+            line.emit();
+        }
+
+        DEFINE_HSM_STATE(CartMonitorState)
     };
 
     struct WelcomeScene : BaseState {
         bn::vector<bn::sprite_ptr, 128> text_sprites;
 
         void OnEnter() override {
-            text_sprites.clear();
-
-            Owner().textGenerator.generate(0, -4 * 16, "Luigi's Lucky RTC", text_sprites);
-            Owner().textGenerator.generate(0, -2 * 16, "You can hot-swap on this screen.", text_sprites);
-            Owner().textGenerator.generate(0, +0 * 16, "Insert your desired hardware!", text_sprites);
-            Owner().textGenerator.generate(0, +2 * 16, "Built with Butano, made by @aronson", text_sprites);
-            Owner().textGenerator.generate(0, +3 * 16, "Music Credit: Nighthawk - Trams.xm", text_sprites);
-            Owner().textGenerator.generate(0, +4 * 16, "START: query RTC module", text_sprites);
-        }
-
-        void Update() override {
-            pollStatusSprite();
+            using Priority = TextQueue::Priority;
+            Owner().clearText(text_sprites);
+
+            Owner().queueText(0, -4 * 16, "Luigi's Lucky RTC", text_sprites, Priority::High);
+            Owner().queueText(0, -2 * 16, "You can hot-swap on this screen.", text_sprites);
+            Owner().queueText(0, +0 * 16, "Insert your desired hardware!", text_sprites);
+            Owner().queueText(0, +1 * 16, "A: test the save chip", text_sprites);
+            Owner().queueText(0, +2 * 16, "Built with Butano, made by @aronson", text_sprites, Priority::Low);
+            Owner().queueText(0, +3 * 16, "Music Credit: Nighthawk - Trams.xm", text_sprites, Priority::Low);
+            Owner().queueText(0, +4 * 16, "START: query RTC module", text_sprites, Priority::High);
         }
 
         Transition GetTransition() override {
             if (bn::keypad::start_pressed()) {
                 return SiblingTransition<StatusScene>();
+            } else if (bn::keypad::a_pressed()) {
+                return SiblingTransition<BackupScene>();
             }
             return NoTransition();
         }
 
         void OnExit() override {
+            Owner().textQueue.discard(text_sprites);
             bn::core::update();
         }
 
@@ -410,28 +559,53 @@ struct ClientStates {
     struct StatusScene : BaseState {
         bn::vector<bn::sprite_ptr, 128> text_sprites;
 
+        unsigned renderedGeneration = 0;
+        unsigned short renderedStatus = 0;
+        bool renderedConfirmed = false;
+
         void OnEnter() override {
-            text_sprites.clear();
-            Owner().textGenerator.generate(0, -4 * 16, "Negotiation with RTC module", text_sprites);
+            // Transitions run before the states update, so this is the previous frame's poll result.
+            // Update redraws if this frame's poll changes anything.
+            render();
+        }
+
+        void render() {
+            renderedGeneration = Owner().handledCartGeneration;
+            renderedStatus = Owner().rtcStatus;
+            renderedConfirmed = Owner().cacheConfirmed;
+            Owner().clearText(text_sprites);
+            Owner().queueText(0, -4 * 16, "Negotiation with RTC module", text_sprites);
 
-            // Update owner state
-            pollStatusSprite();
             // Report on result
             bn::string<23> gameCode = "Game code: ";
             bn::string<64> text;
             bn::string<64> additional;
             bn::string<64> additional2;
             bn::string<64> nextSteps;
-            auto code = Owner().lastSeenGameCode;
+            const bn::string<12> &code = Owner().cartMonitor.gameTitle();
             if (code.empty() || code == bn::to_string<1>("P")) {
                 gameCode = "";
                 additional = "Cart not plugged?";
             } else {
                 gameCode += code;
             }
+            const GameDatabase::GameInfo *game = Owner().knownGame;
+            bn::string<48> hardware;
+            if (game) {
+                hardware = game->name;
+                hardware += game->rtc == GameDatabase::RtcChip::None ? " (no RTC" : " (RTC";
+                if (game->peripherals & GameDatabase::PERIPHERAL_SOLAR) hardware += ", solar";
+                if (game->peripherals & GameDatabase::PERIPHERAL_GYRO) hardware += ", gyro";
+                if (game->peripherals & GameDatabase::PERIPHERAL_RUMBLE) hardware += ", rumble";
+                hardware += ")";
+            }
             int checkValue = Owner().rtcStatus;
             Owner().rtcFail = false;
+            // The database only annotates what the bus said, it never overrules it
+            bool listedWithoutRtc = game && game->rtc == GameDatabase::RtcChip::None;
+            bool answered = true;
             if (checkValue == 0xFF) {
+                answered = false;
                 text = "Cart bus returned only noise.";
                 additional2 = "Inaccurate/misconfigured emu?";
                 nextSteps = "START: proceed to attempt reset";
@@ -449,8 +623,14 @@ struct ClientStates {
                 auto agbabiRtcDatetime = __agbabi_rtc_datetime();
                 if (!__agbabi_rtc_time() && !agbabiRtcDatetime[0] && !agbabiRtcDatetime[1]) {
                     text = "RTC chip sent no data.";
-                    additional = "Cart has no RTC?";
-                    additional2 = "Inaccurate/misconfigured emu?";
+                    if (listedWithoutRtc) {
+                        additional = "Title shipped without an RTC";
+                    } else if (game) {
+                        additional = "Title has an RTC: check chip/wiring";
+                    } else {
+                        additional = "Cart has no RTC?";
+                        additional2 = "Inaccurate/misconfigured emu?";
+                    }
                     nextSteps = "START: proceed to attempt init";
                     Owner().rtcFail = true;
                 } else {
@@ -458,15 +638,39 @@ struct ClientStates {
                     nextSteps = "START: proceed to read date & time";
                 }
             }
+            if (listedWithoutRtc && additional.empty()) {
+                additional = answered ? "RTC found, title shipped without one" : "Title shipped without an RTC";
+            }
+            if (Owner().cacheHit && additional2.empty()) {
+                if (!Owner().cacheConfirmed) {
+                    additional2 = "Seen before, confirming...";
+                } else if (Owner().cachedEntry.lastSeenDate) {
+                    additional2 = "Last seen 20";
+                    RtcSceneManager::appendBcd(additional2, Owner().cachedEntry.lastSeenDate);
+                    additional2 += '/';
+                    RtcSceneManager::appendBcd(additional2, Owner().cachedEntry.lastSeenDate >> 8);
+                    additional2 += '/';
+                    RtcSceneManager::appendBcd(additional2, Owner().cachedEntry.lastSeenDate >> 16);
+                    additional2 += ' ';
+                    // Hour carries the PM flag up top
+                    RtcSceneManager::appendBcd(additional2, Owner().cachedEntry.lastSeenTime & 0x3F);
+                    additional2 += ':';
+                    RtcSceneManager::appendBcd(additional2, Owner().cachedEntry.lastSeenTime >> 8);
+                }
+            }
+            if (additional2.empty() && hasSolarSensor()) additional2 = "A: read the solar sensor";
+            // The verdict and what to do about it first, the rest fills in behind
+            using Priority = TextQueue::Priority;
+            Owner().queueText(0, -3 * 16, hardware, text_sprites);
             if (checkValue & 0x80) {
-                Owner().textGenerator.generate(0, -2 * 16, "Power flag high: battery dead?", text_sprites);
+                Owner().queueText(0, -2 * 16, "Power flag high: battery dead?", text_sprites, Priority::High);
             }
-            Owner().textGenerator.generate(0, -1 * 16, gameCode, text_sprites);
-            Owner().textGenerator.generate(0, -0 * 16, text, text_sprites);
-            Owner().textGenerator.generate(0, +1 * 16, additional, text_sprites);
-            Owner().textGenerator.generate(0, +2 * 16, additional2, text_sprites);
-            Owner().textGenerator.generate(0, +3 * 16, "SELECT: back to hot-swap screen", text_sprites);
-            Owner().textGenerator.generate(0, +4 * 16, nextSteps, text_sprites);
+            Owner().queueText(0, -1 * 16, gameCode, text_sprites);
+            Owner().queueText(0, -0 * 16, text, text_sprites, Priority::High);
+            Owner().queueText(0, +1 * 16, additional, text_sprites);
+            Owner().queueText(0, +2 * 16, additional2, text_sprites, Priority::Low);
+            Owner().queueText(0, +3 * 16, "SELECT: back to hot-swap screen", text_sprites, Priority::Low);
+            Owner().queueText(0, +4 * 16, nextSteps, text_sprites, Priority::High);
         }
 
         Transition GetTransition() override {
@@ -476,15 +680,29 @@ struct ClientStates {
                 return SiblingTransition<ResetScene>();
             } else if (bn::keypad::start_pressed()) {
                 return SiblingTransition<WallClockScene>();
+            } else if (bn::keypad::a_pressed() && hasSolarSensor()) {
+                return SiblingTransition<SolarScene>();
             }
             return NoTransition();
         }
 
+        /**
+         * Only known titles, the same port pins drive gyros and rumble motors on other carts
+         */
+        bool hasSolarSensor() {
+            return Owner().knownGame && Owner().knownGame->peripherals & GameDatabase::PERIPHERAL_SOLAR;
+        }
+
         void Update() override {
-            pollStatusSprite();
+            // A swap or a cached result being confirmed may have changed the story
+            if (renderedGeneration != Owner().handledCartGeneration || renderedStatus != Owner().rtcStatus ||
+                renderedConfirmed != Owner().cacheConfirmed) {
+                render();
+            }
         }
 
         void OnExit() override {
+            Owner().textQueue.discard(text_sprites);
             bn::core::update();
         }
 
@@ -494,11 +712,17 @@ struct ClientStates {
     struct WallClockScene : BaseState {
         bn::vector<bn::sprite_ptr, 64> text_sprites;
         bn::vector<bn::sprite_ptr, 33> afternoon_sprites;
-        bn::vector<bn::sprite_ptr, 31> time_sprites;
+        // Redrawn every frame, so drawn from the glyph atlas
+        GlyphLine time_line;
         int status = 0;
+        int shownMode = -1;
+        // L pressed here and released without being part of a combo (L+B HUD, L+R trace export)
+        bool soloL = false;
 
         void OnEnter() override {
             status = Owner().rtcStatus;
+            shownMode = -1;
+            soloL = false;
             auto agbabiRtcDatetime = __agbabi_rtc_datetime();
             if (!__agbabi_rtc_time() && !agbabiRtcDatetime[0] && !agbabiRtcDatetime[1]) {
                 Owner().rtcFail = true;
@@ -509,13 +733,15 @@ struct ClientStates {
 
         void render() {
             text_sprites.clear();
-            Owner().textGenerator.generate(0, -4 * 16, "Read Date and Time", text_sprites);
+            Owner().generateText(0, -4 * 16, "Read Date and Time", text_sprites);
             if (bn::date::active() && bn::time::active()) {
-                Owner().textGenerator.generate(0, -2 * 16, "You can hot-swap on this screen!", text_sprites);
-                Owner().textGenerator.generate(0, +3 * 16, "SELECT: reset (will confirm first)", text_sprites);
-                Owner().textGenerator.generate(0, +4 * 16, "START: edit (saves current time)", text_sprites);
+                Owner().generateText(0, -3 * 16, "Tap L: clock drift   UP: bus timing", text_sprites);
+                Owner().generateText(0, -2 * 16, "You can hot-swap on this screen!", text_sprites);
+                Owner().generateText(0, -1 * 16, "A: stress test   B: batch provision", text_sprites);
+                Owner().generateText(0, +3 * 16, "SELECT: reset (will confirm first)", text_sprites);
+                Owner().generateText(0, +4 * 16, "START: edit (saves current time)", text_sprites);
             } else {
-                Owner().textGenerator.generate(0, +4 * 16, "SELECT: proceed to attempt reset", text_sprites);
+                Owner().generateText(0, +4 * 16, "SELECT: proceed to attempt reset", text_sprites);
             }
         }
 
@@ -523,7 +749,8 @@ struct ClientStates {
             bn::string<64> text;
             Owner().rtcFail = false;
 
-            if (bn::keypad::r_pressed()) {
+            // L+R is the trace export hold in TRACE builds, L first keeps the mode as it is
+            if (bn::keypad::r_pressed() && !bn::keypad::l_held()) {
                 if (status & 0x40) {
                     status = 0x00;
                 } else {
@@ -534,16 +761,19 @@ struct ClientStates {
                 Owner().rtcStatus = RtcSceneManager::readStatus();
             }
 
-            bn::string<33> afternoon = "R: toggle 12/24h (currently: ";
-            afternoon += (Owner().rtcStatus & 0x40 ? "24h" : "12h");
-            afternoon += ")";
-            afternoon_sprites.clear();
-            Owner().textGenerator.generate(0, 2 * 16, afternoon, afternoon_sprites);
+            if (shownMode != (Owner().rtcStatus & 0x40)) {
+                shownMode = Owner().rtcStatus & 0x40;
+                bn::string<33> afternoon = "R: toggle 12/24h (currently: ";
+                afternoon += (shownMode ? "24h" : "12h");
+                afternoon += ")";
+                afternoon_sprites.clear();
+                Owner().generateText(0, 2 * 16, afternoon, afternoon_sprites);
+            }
 
             if (status != Owner().rtcStatus) {
                 text_sprites.clear();
                 render();
-                Owner().textGenerator.generate(0, 1 * 16, "Module rejected status write...", text_sprites);
+                Owner().generateText(0, 1 * 16, "Module rejected status write...", text_sprites);
             }
 
             if (bn::optional<bn::date> date = bn::date::current()) {
@@ -560,18 +790,31 @@ struct ClientStates {
                 return;
             }
 
-            time_sprites.clear();
-            Owner().textGenerator.generate(0, 0, text, time_sprites);
-            pollStatusSprite();
+            time_line.set(Owner().glyphAtlas, 0, 0, text);
         }
 
         Transition GetTransition() override {
+            if (bn::keypad::l_pressed()) {
+                soloL = true;
+            } else if (bn::keypad::b_pressed() || bn::keypad::r_pressed()) {
+                soloL = false;
+            }
+
             if (Owner().rtcFail) {
                 return SiblingTransition<StatusScene>();
             } else if (bn::keypad::select_pressed()) {
                 return SiblingTransition<ResetScene>();
             } else if (bn::keypad::start_pressed() && bn::date::active() && bn::time::active()) {
                 return SiblingTransition<EditScene>();
+            } else if (bn::keypad::l_released() && soloL && bn::date::active() && bn::time::active()) {
+                return SiblingTransition<DriftScene>();
+            } else if (bn::keypad::a_pressed() && bn::date::active() && bn::time::active()) {
+                return SiblingTransition<SoakScene>();
+            } else if (bn::keypad::b_pressed() && !bn::keypad::l_held() && bn::date::active() &&
+                       bn::time::active()) {
+                return SiblingTransition<ProvisionScene>();
+            } else if (bn::keypad::up_pressed() && bn::date::active() && bn::time::active()) {
+                return SiblingTransition<TimingScene>();
             }
             return NoTransition();
         }
@@ -618,10 +861,10 @@ struct ClientStates {
             TimeFormatter formatter(year, month, day, hour, minute, second, afternoon, selectedComponent,
                                     Owner().rtcStatus);
             readLine = formatter.renderLine();
-            Owner().textGenerator.generate(0, -4 * 16, "RTC Edit", text_sprites);
-            Owner().textGenerator.generate(0, 0 * 16, readLine, time_sprites);
-            Owner().textGenerator.generate(0, +3 * 16, "SELECT: return", text_sprites);
-            Owner().textGenerator.generate(0, +4 * 16, "START: save", text_sprites);
+            Owner().generateText(0, -4 * 16, "RTC Edit", text_sprites);
+            Owner().generateText(0, 0 * 16, readLine, time_sprites);
+            Owner().generateText(0, +3 * 16, "SELECT: return", text_sprites);
+            Owner().generateText(0, +4 * 16, "START: save", text_sprites);
         }
 
         void Update() override {
@@ -709,9 +952,8 @@ struct ClientStates {
                                         Owner().rtcStatus);
                 readLine = formatter.renderLine();
                 time_sprites.clear();
-                Owner().textGenerator.generate(0, 0 * 16, readLine, time_sprites);
+                Owner().generateText(0, 0 * 16, readLine, time_sprites);
             }
-            pollStatusSprite();
         }
 
         Transition GetTransition() override {
@@ -738,9 +980,28 @@ struct ClientStates {
         DEFINE_HSM_STATE(EditScene)
     };
 
+    /**
+     * Sends reset or init, then polls status until the chip reports its post-reset state and shows how long that took
+     */
     struct ResetScene : BaseState {
+        // Polling gets half a frame at a time
+        static constexpr unsigned BUDGET_CYCLES = 280896 / 2;
+        // A chip that hasn't come back by now is reported as not ready
+        static constexpr unsigned TIMEOUT_CYCLES = CycleCounter::CYCLES_PER_SECOND / 2;
+        // Healthy chips are ready by the first poll or two, each poll being a couple of hundred microseconds
+        static constexpr unsigned SLOW_RESET_US = 2000;
+
         bn::vector<bn::sprite_ptr, 128> text_sprites;
+        bn::vector<bn::sprite_ptr, 64> result_sprites;
         bn::string<35> description;
+        Task::Runner runner;
+        bool finished = false;
+        bool ready = false;
+        unsigned latencyMicroseconds = 0;
+        int polls = 0;
+        int finalStatus = 0;
+        // Why a status of zero still didn't prove a chip is there, nullptr if it did or the status never came back
+        const char *absent = nullptr;
 
         void OnEnter() override {
             description = Owner().rtcStatus & 0x80 ?
@@ -749,22 +1010,105 @@ struct ClientStates {
                           "RTC not found: attempt reset?" :
                           "RTC ready: confirm reset?";
             text_sprites.clear();
-            Owner().textGenerator.generate(0, -4 * 16, Owner().rtcStatus == 0x82 ? "RTC Initialize" : "RTC Reset",
-                                           text_sprites);
-            Owner().textGenerator.generate(0, +0 * 16, description, text_sprites);
-            Owner().textGenerator.generate(0, +3 * 16,
-                                           Owner().rtcStatus == 0x82 ? "SELECT: send init" : "SELECT: send reset",
-                                           text_sprites);
-            Owner().textGenerator.generate(0, +4 * 16, "START: force read RTC", text_sprites);
+            Owner().generateText(0, -4 * 16, Owner().rtcStatus == 0x82 ? "RTC Initialize" : "RTC Reset",
+                                 text_sprites);
+            Owner().generateText(0, +0 * 16, description, text_sprites);
+            Owner().generateText(0, +3 * 16,
+                                 Owner().rtcStatus == 0x82 ? "SELECT: send init" : "SELECT: send reset",
+                                 text_sprites);
+            Owner().generateText(0, +4 * 16, "START: force read RTC", text_sprites);
+        }
+
+        Task::Job reset() {
+            CycleCounter::ensureRunning();
+            RtcSceneManager::resetChip();
+            unsigned start = CycleCounter::now();
+            polls = 0;
+            while (true) {
+                finalStatus = RtcSceneManager::readStatus();
+                polls++;
+                unsigned elapsed = CycleCounter::now() - start;
+                // Reset clears every status bit, including the power flag and 24 hour mode
+                bool cleared = finalStatus == 0x00;
+                if (cleared || elapsed >= TIMEOUT_CYCLES) {
+                    latencyMicroseconds = CycleCounter::toMicroseconds(elapsed);
+                    break;
+                }
+                co_await Task::checkpoint();
+            }
+            absent = nullptr;
+            ready = false;
+            if (finalStatus != 0x00) co_return;
+
+            // An empty slot reads zero too, SIO floats to the ROM bit under it. Only a chip answers the rest.
+            co_await Task::checkpoint();
+            unsigned char bcd[7];
+            RtcSceneManager::readDateTime(bcd);
+            // Reset puts the clock at 2000-01-01 00:00:00, allow for a second ticking over meanwhile
+            if (bcd[0] != 0x00 || bcd[1] != 0x01 || bcd[2] != 0x01 || (bcd[4] & 0x3F) != 0x00 || bcd[5] != 0x00 ||
+                bcd[6] > 0x01) {
+                absent = "Clock not at reset value: no RTC?";
+                co_return;
+            }
+            co_await Task::checkpoint();
+            RtcSceneManager::writeStatus(0x40);
+            int written = RtcSceneManager::readStatus();
+            // Back to what reset left, this scene only checks the chip
+            RtcSceneManager::writeStatus(0x00);
+            if (written != 0x40 || RtcSceneManager::readStatus() != 0x00) {
+                absent = "Status write didn't read back: no RTC?";
+                co_return;
+            }
+            ready = true;
+        }
+
+        void renderResult() {
+            bn::string<64> latency = ready ? "Ready after " : "Not ready after ";
+            latency += bn::to_string<10>(latencyMicroseconds);
+            latency += " us, ";
+            latency += bn::to_string<8>(polls);
+            latency += polls == 1 ? " poll" : " polls";
+
+            bn::string<64> verdict;
+            if (absent) {
+                verdict = absent;
+            } else if (!ready) {
+                verdict = "Status stuck at 0x";
+                verdict += "0123456789ABCDEF"[finalStatus >> 4 & 0xF];
+                verdict += "0123456789ABCDEF"[finalStatus & 0xF];
+                verdict += ": chip or wiring?";
+            } else if (latencyMicroseconds > SLOW_RESET_US) {
+                verdict = "Slow to come back: marginal chip?";
+            } else {
+                verdict = "Within normal reset latency";
+            }
+
+            result_sprites.clear();
+            Owner().generateText(0, +1 * 16, latency, result_sprites);
+            Owner().generateText(0, +2 * 16, verdict, result_sprites);
         }
 
         void Update() override {
-            pollStatusSprite();
+            if (!runner.running()) return;
+            runner.run(BUDGET_CYCLES);
+            if (runner.running()) return;
+            finished = true;
+            Owner().rtcStatus = finalStatus;
+            Owner().rtcFail = !ready;
+            renderResult();
+            text_sprites.clear();
+            Owner().generateText(0, -4 * 16, "RTC Reset", text_sprites);
+            Owner().generateText(0, +3 * 16, "A: status   SELECT: send again", text_sprites);
+            Owner().generateText(0, +4 * 16, "START: force read RTC", text_sprites);
         }
 
         Transition GetTransition() override {
-            if (bn::keypad::select_pressed()) {
-                RtcSceneManager::resetChip();
+            if (runner.running()) {
+                return NoTransition();
+            } else if (bn::keypad::select_pressed()) {
+                result_sprites.clear();
+                if (!runner.start(reset())) return SiblingTransition<StatusScene>();
+            } else if (bn::keypad::a_pressed() && finished) {
                 return SiblingTransition<StatusScene>();
             } else if (bn::keypad::start_pressed()) {
                 return SiblingTransition<WallClockScene>();
@@ -773,9 +1117,829 @@ struct ClientStates {
         }
 
         void OnExit() override {
+            runner.cancel();
             bn::core::update();
         }
 
         DEFINE_HSM_STATE(ResetScene)
     };
+    struct DriftScene : BaseState {
+        bn::vector<bn::sprite_ptr, 64> text_sprites;
+        bn::vector<bn::sprite_ptr, 64> result_sprites;
+        DriftMeter meter;
+
+        void OnEnter() override {
+            text_sprites.clear();
+            Owner().generateText(0, -4 * 16, "RTC Drift Measurement", text_sprites);
+            Owner().generateText(0, +3 * 16, "Leave running: longer is tighter", text_sprites);
+            Owner().generateText(0, +4 * 16, "SELECT: back to wall clock", text_sprites);
+            meter.start();
+            render();
+        }
+
+        void render() {
+            bn::string<64> edges = "Ticks: ";
+            edges += bn::to_string<8>(meter.edges());
+            edges += " Missed: ";
+            edges += bn::to_string<8>(meter.missedWindows());
+
+            unsigned elapsed = meter.elapsedSeconds();
+            bn::string<64> duration = "Elapsed:";
+            RtcFormat::appendTime(duration, static_cast<int>(elapsed / 3600), static_cast<int>(elapsed / 60 % 60),
+                                  static_cast<int>(elapsed % 60), false);
+
+            bn::string<64> drift;
+            if (meter.hasEstimate()) {
+                drift = "Drift: ";
+                RtcFormat::appendTenths(drift, meter.driftTenthsPpm(), true);
+                drift += " ppm +/- ";
+                RtcFormat::appendTenths(drift, meter.confidenceTenthsPpm(), false);
+            } else {
+                drift = "Drift: waiting for ticks...";
+            }
+
+            result_sprites.clear();
+            Owner().generateText(0, -2 * 16, edges, result_sprites);
+            Owner().generateText(0, -1 * 16, duration, result_sprites);
+            Owner().generateText(0, +0 * 16, drift, result_sprites);
+            Owner().generateText(0, +1 * 16, "95% confidence, vs 16.78 MHz", result_sprites);
+        }
+
+        void Update() override {
+            // Only redraw on a fresh tick, between windows we just sit in Halt
+            if (meter.update(RtcSceneManager::readTime)) {
+                render();
+            }
+        }
+
+        Transition GetTransition() override {
+            if (bn::keypad::select_pressed()) {
+                return SiblingTransition<WallClockScene>();
+            }
+            return NoTransition();
+        }
+
+        void OnExit() override {
+            bn::core::update();
+        }
+
+        DEFINE_HSM_STATE(DriftScene)
+    };
+    struct SoakScene : BaseState {
+        // Half a frame of bus traffic, the rest is left for text and music
+        static constexpr unsigned BUDGET_CYCLES = 280896 / 2;
+        static constexpr int REFRESH_FRAMES = 30;
+
+        bn::vector<bn::sprite_ptr, 64> text_sprites;
+        bn::vector<bn::sprite_ptr, 96> result_sprites;
+        SoakTest soak;
+        bool paused = false;
+        int refreshFrames = 0;
+        // The cart under test, a swap must never get another cart's clock written to it
+        unsigned cartGeneration = 0;
+        unsigned cartCode = 0;
+
+        void OnEnter() override {
+            text_sprites.clear();
+            Owner().generateText(0, -4 * 16, "RTC Soak Test", text_sprites);
+            Owner().generateText(0, +2 * 16, "Pulling the cart stops the test", text_sprites);
+            Owner().generateText(0, +3 * 16, "START: pause/resume", text_sprites);
+            Owner().generateText(0, +4 * 16, "SELECT: stop, restore clock", text_sprites);
+            paused = false;
+            refreshFrames = 0;
+            cartGeneration = Owner().cartMonitor.generation();
+            cartCode = Owner().cartMonitor.gameCode();
+            soak.start({RtcSceneManager::readStatus, RtcSceneManager::writeStatus, RtcSceneManager::readDateTime,
+                        RtcSceneManager::setRTC, CartMonitor::removals});
+        }
+
+        void render() {
+            bn::string<64> rate = "Tx: ";
+            rate += bn::to_string<10>(soak.transactions());
+            rate += " (";
+            rate += bn::to_string<8>(soak.transactionsPerSecond());
+            rate += "/s)";
+            if (soak.abandoned()) {
+                rate += " cart pulled";
+            } else if (paused) {
+                rate += " paused";
+            }
+
+            // Errors per million bits
+            bn::string<64> errors = "Bit errors: ";
+            errors += bn::to_string<10>(soak.bitErrors());
+            errors += " (";
+            unsigned bits = soak.bitsChecked();
+            errors += bn::to_string<10>(bits ? static_cast<unsigned>(
+                    static_cast<unsigned long long>(soak.bitErrors()) * 1000000 / bits) : 0);
+            errors += " ppm)";
+
+            static constexpr const char *fieldNames[] = {"STS", "Y", "M", "D", "W", "h", "m", "s"};
+            bn::string<64> fields = "Failed:";
+            bool anyFailed = false;
+            for (int i = 0; i < SoakTest::FIELD_COUNT; i++) {
+                unsigned failures = soak.fieldErrors(static_cast<SoakTest::Field>(i));
+                if (!failures) continue;
+                fields += ' ';
+                fields += fieldNames[i];
+                fields += '=';
+                fields += bn::to_string<10>(failures);
+                anyFailed = true;
+            }
+            if (!anyFailed) fields += " none";
+
+            bn::string<64> power = "Power flag raised: ";
+            power += bn::to_string<10>(soak.powerFlagRaises());
+            power += "x";
+
+            result_sprites.clear();
+            Owner().generateText(0, -2 * 16, rate, result_sprites);
+            Owner().generateText(0, -1 * 16, errors, result_sprites);
+            Owner().generateText(0, +0 * 16, fields, result_sprites);
+            Owner().generateText(0, +1 * 16, power, result_sprites);
+        }
+
+        void Update() override {
+            // The soak itself stops on the removal interrupt, this catches a swap that settled in the meantime
+            if (soak.running() && Owner().cartMonitor.generation() != cartGeneration) {
+                soak.abandon();
+                refreshFrames = 0;
+            }
+            if (bn::keypad::start_pressed()) {
+                paused = !paused;
+                refreshFrames = 0;
+            }
+            bool wasRunning = soak.running();
+            soak.run(paused ? 0 : BUDGET_CYCLES);
+            if (wasRunning && !soak.running()) refreshFrames = 0;
+            if (--refreshFrames > 0) return;
+            refreshFrames = REFRESH_FRAMES;
+            render();
+        }
+
+        Transition GetTransition() override {
+            if (bn::keypad::select_pressed()) {
+                return SiblingTransition<WallClockScene>();
+            }
+            return NoTransition();
+        }
+
+        void OnExit() override {
+            soak.finish();
+            if (soak.transactions() && TestReport::claim(TestReport::KIND_SOAK, cartGeneration)) {
+                TestReport::Line line("soak", cartCode);
+                line.field("result", soak.abandoned() ? "pulled" : "done")
+                        .field("tx", static_cast<int>(soak.transactions()))
+                        .field("tx_per_s", static_cast<int>(soak.transactionsPerSecond()))
+                        .field("bits", static_cast<int>(soak.bitsChecked()))
+                        .field("bit_errors", static_cast<int>(soak.bitErrors()))
+                        .field("power_raises", static_cast<int>(soak.powerFlagRaises()))
+                        .field("seconds", static_cast<int>(soak.elapsedSeconds()));
+                line.emit();
+            }
+            bn::core::update();
+        }
+
+        DEFINE_HSM_STATE(SoakScene)
+    };
+    /**
+     * Sets every cart inserted to the same reference time, taken from the cart in the slot on entry
+     * and kept ticking in software from then on.
+     */
+    struct ProvisionScene : BaseState {
+        // Bus work gets half a frame, the rest keeps the clock and text at 60 fps
+        static constexpr unsigned BUDGET_CYCLES = 280896 / 2;
+        // How long a chip gets to drop its power flag after init
+        static constexpr int INIT_POLL_FRAMES = 30;
+
+        bn::vector<bn::sprite_ptr, 64> text_sprites;
+        GlyphLine clock_line;
+        bn::vector<bn::sprite_ptr, 96> result_sprites;
+        SoftClock clock;
+        RtcFormat::DateTime shown;
+        unsigned seenGeneration = 0;
+        int passed = 0;
+        int failed = 0;
+        Task::Runner runner;
+        const char *failure = nullptr;
+        // Last cart's timings and outcome, for the test report
+        unsigned writeCycles = 0;
+        unsigned verifyCycles = 0;
+        int provisionedStatus = 0;
+        RtcFormat::DateTime written;
+        // The cart the running job was started on, the monitor moves on to the next one as soon as it settles
+        unsigned jobRemovals = 0;
+        unsigned jobCode = 0;
+        unsigned short jobSignature = 0;
+        bn::string<12> jobTitle;
+
+        void OnEnter() override {
+            int status = RtcSceneManager::readStatus();
+            unsigned char bcd[7];
+            RtcSceneManager::readDateTime(bcd);
+            clock.start(RtcFormat::decodeDateTime(bcd, !(status & 0x40)));
+            // The reference cart is already set
+            seenGeneration = Owner().cartMonitor.generation();
+            passed = 0;
+            failed = 0;
+
+            text_sprites.clear();
+            Owner().generateText(0, -4 * 16, "Batch Provisioning", text_sprites);
+            Owner().generateText(0, +3 * 16, "Hot-swap: each cart is set on insert", text_sprites);
+            Owner().generateText(0, +4 * 16, "SELECT: stop", text_sprites);
+            renderClock();
+            renderResult("Insert the next cart", "");
+        }
+
+        void renderClock() {
+            shown = clock.now();
+            bn::string<64> text = "Reference: 20";
+            RtcFormat::appendBcd(text, RtcFormat::toBcd(shown.year));
+            text += '/';
+            RtcFormat::appendBcd(text, RtcFormat::toBcd(shown.month));
+            text += '/';
+            RtcFormat::appendBcd(text, RtcFormat::toBcd(shown.day));
+            RtcFormat::appendTime(text, shown.hour, shown.minute, shown.second, false);
+            clock_line.set(Owner().glyphAtlas, 0, -3 * 16, text);
+        }
+
+        void renderResult(const bn::string_view &headline, const bn::string_view &detail) {
+            bn::string<64> tally = "Passed: ";
+            tally += bn::to_string<8>(passed);
+            tally += "  Failed: ";
+            tally += bn::to_string<8>(failed);
+            if (unsigned elapsed = clock.elapsedSeconds()) {
+                tally += "  ";
+                tally += bn::to_string<8>(static_cast<unsigned>(passed + failed) * 3600 / elapsed);
+                tally += "/h";
+            }
+
+            result_sprites.clear();
+            Owner().generateText(0, -1 * 16, headline, result_sprites);
+            Owner().generateText(0, +0 * 16, detail, result_sprites);
+            Owner().generateText(0, +1 * 16, tally, result_sprites);
+        }
+
+        /**
+         * Leaves why the cart failed in failure, nullptr once it holds the reference time
+         */
+        Task::Job provision() {
+            failure = nullptr;
+            writeCycles = 0;
+            verifyCycles = 0;
+            provisionedStatus = 0;
+            // Titles listed without an RTC are still tried, only the bus decides
+            int status = RtcSceneManager::readStatus();
+            if (status == 0xFF) {
+                failure = "No RTC answered";
+                co_return;
+            }
+            if (status & 0x80) {
+                // Power flag: the chip needs initialising before it will keep time, poll once a frame until it has
+                RtcSceneManager::resetChip();
+                for (int frame = 0; (status = RtcSceneManager::readStatus()) & 0x80; frame++) {
+                    if (frame == INIT_POLL_FRAMES) {
+                        failure = "Power flag stuck after init";
+                        co_return;
+                    }
+                    co_await Task::nextFrame();
+                }
+            }
+            if (!(status & 0x40)) {
+                // Init leaves the chip in 12 hour mode, which Pokemon's RTC check treats as uninitialised and resets
+                RtcSceneManager::writeStatus(static_cast<unsigned short>((status | 0x40) & 0x7F));
+                status = RtcSceneManager::readStatus();
+                if (!(status & 0x40)) {
+                    failure = "Module rejected 24 hour mode";
+                    co_return;
+                }
+            }
+            co_await Task::checkpoint();
+            provisionedStatus = status;
+            // Always 24 hour from here, see above
+            constexpr bool twelveHour = false;
+            RtcFormat::DateTime target = clock.now();
+            written = target;
+            CycleCounter::ensureRunning();
+            unsigned start = CycleCounter::now();
+            RtcSceneManager::writeDateTime(target, twelveHour);
+            writeCycles = CycleCounter::now() - start;
+            co_await Task::checkpoint();
+
+            start = CycleCounter::now();
+            unsigned char bcd[7];
+            RtcSceneManager::readDateTime(bcd);
+            RtcFormat::DateTime readBack = RtcFormat::decodeDateTime(bcd, twelveHour);
+            verifyCycles = CycleCounter::now() - start;
+            RtcFormat::DateTime nextSecond = target;
+            RtcFormat::addSeconds(nextSecond, 1);
+            if (readBack != target && readBack != nextSecond) {
+                failure = "Read back a different time";
+                co_return;
+            }
+            status = RtcSceneManager::readStatus();
+            if (status != provisionedStatus) {
+                failure = "Status changed after the time write";
+                co_return;
+            }
+
+            Owner().rtcStatus = status;
+            Owner().rtcFail = false;
+            Owner().showPresence(CartCache::Presence::Full);
+            CartCache::store(jobSignature, jobCode, status,
+                             CartCache::Presence::Full, 0, 0);
+        }
+
+        void Update() override {
+            clock.update();
+            if (clock.now().second != shown.second) renderClock();
+
+            unsigned generation = Owner().cartMonitor.generation();
+            if (runner.running()) {
+                // The removal interrupt lands well before the swap settles, stop writing to a cart on its way out
+                if (CartMonitor::removals() != jobRemovals || generation != seenGeneration) {
+                    runner.cancel();
+                    failure = "Cart swapped before it was set";
+                    finish();
+                    return;
+                }
+                runner.run(BUDGET_CYCLES);
+                if (!runner.running()) finish();
+                return;
+            }
+
+            // Wait for the cart monitor state to have classified the new cart first
+            if (generation == seenGeneration || Owner().handledCartGeneration != generation) return;
+            seenGeneration = generation;
+            if (!Owner().cartMonitor.cartPresent()) {
+                renderResult("Insert the next cart", "");
+                return;
+            }
+
+            jobRemovals = CartMonitor::removals();
+            jobCode = Owner().cartMonitor.gameCode();
+            jobSignature = Owner().cartMonitor.signature();
+            jobTitle = Owner().cartMonitor.gameTitle();
+            if (!runner.start(provision())) {
+                failure = "Out of task frames";
+                finish();
+                return;
+            }
+            runner.run(BUDGET_CYCLES);
+            if (!runner.running()) finish();
+        }
+
+        void finish() {
+            bn::string<64> headline = "#";
+            headline += bn::to_string<8>(passed + failed + 1);
+            headline += ' ';
+            if (failure) {
+                failed++;
+                headline += "FAIL ";
+            } else {
+                passed++;
+                headline += "PASS ";
+            }
+            headline += jobTitle;
+            renderResult(headline, failure ? failure : "Set to reference, next cart please");
+            report();
+        }
+
+        void report() const {
+            if (!TestReport::claim(TestReport::KIND_PROVISION, seenGeneration)) return;
+            TestReport::Line line("provision", jobCode);
+            line.hex("sig", jobSignature, 4)
+                    .hex("status", provisionedStatus, 2)
+                    .field("result", failure ? "fail" : "pass");
+            if (failure) line.field("reason", failure);
+            if (writeCycles) {
+                line.bcd("date", RtcFormat::toBcd(written.year) | RtcFormat::toBcd(written.month) << 8 |
+                                 RtcFormat::toBcd(written.day) << 16, 3, '-', "20")
+                        .bcd("time", RtcFormat::toBcd(written.hour) | RtcFormat::toBcd(written.minute) << 8 |
+                                     RtcFormat::toBcd(written.second) << 16, 3, ':', "")
+                        .field("write_us", static_cast<int>(CycleCounter::toMicroseconds(writeCycles)))
+                        .field("verify_us", static_cast<int>(CycleCounter::toMicroseconds(verifyCycles)));
+            }
+            line.emit();
+        }
+
+        Transition GetTransition() override {
+            if (bn::keypad::select_pressed()) {
+                return SiblingTransition<WallClockScene>();
+            }
+            return NoTransition();
+        }
+
+        void OnExit() override {
+            runner.cancel();
+            bn::core::update();
+        }
+
+        DEFINE_HSM_STATE(ProvisionScene)
+    };
+    /**
+     * Save chip type, speed and health. Nothing is written until the user confirms,
+     * and every sector written is restored before moving on to the next.
+     */
+    struct BackupScene : BaseState {
+        // Half a frame of erase polls and chunk writes at a time
+        static constexpr unsigned BUDGET_CYCLES = 280896 / 2;
+        static constexpr int REFRESH_FRAMES = 15;
+
+        bn::vector<bn::sprite_ptr, 64> text_sprites;
+        bn::vector<bn::sprite_ptr, 96> result_sprites;
+        BackupBench bench;
+        bool detecting = true;
+        unsigned cartGeneration = 0;
+        unsigned removalsSeen = 0;
+        int refreshFrames = 0;
+
+        void OnEnter() override {
+            text_sprites.clear();
+            Owner().generateText(0, -4 * 16, "Save Chip Test", text_sprites);
+            Owner().generateText(0, +3 * 16, "Keep the cart in while testing!", text_sprites);
+            Owner().generateText(0, +4 * 16, "SELECT: back (once the test is over)", text_sprites);
+            restart();
+        }
+
+        void restart() {
+            cartGeneration = Owner().cartMonitor.generation();
+            removalsSeen = CartMonitor::removals();
+            detecting = true;
+            bench = BackupBench();
+            BackupMemory::startDetection();
+            render();
+        }
+
+        static void appendHex(bn::string<64> &text, unsigned value) {
+            for (int shift = 12; shift >= 0; shift -= 4) text += "0123456789ABCDEF"[(value >> shift) & 0xF];
+        }
+
+        void render() {
+            BackupMemory::Type type = BackupMemory::detectedType();
+            bn::string<64> chip = detecting ? "Detecting save type..." : BackupMemory::typeName(type);
+            if (!detecting && (type == BackupMemory::Type::Flash64 || type == BackupMemory::Type::Flash128)) {
+                chip += " (ID ";
+                appendHex(chip, BackupMemory::flashId());
+                chip += ")";
+            }
+
+            bn::string<64> state;
+            switch (bench.phase()) {
+                case BackupBench::Phase::Idle:
+                    if (!detecting) {
+                        state = BackupMemory::writable(type) ? "A: test (rewrites, then restores)" : "Nothing to test";
+                    }
+                    break;
+                case BackupBench::Phase::Reading:
+                case BackupBench::Phase::Writing:
+                    state = bench.phase() == BackupBench::Phase::Reading ? "Reading " : "Writing ";
+                    state += bn::to_string<8>(bench.sectorsDone());
+                    state += '/';
+                    state += bn::to_string<8>(bench.sectorTotal());
+                    break;
+                case BackupBench::Phase::Done:
+                    state = "Done, ";
+                    state += bn::to_string<8>(bench.patternErrors());
+                    state += " bad sectors, save restored";
+                    break;
+                case BackupBench::Phase::Failed:
+                    state = bench.failure();
+                    break;
+            }
+
+            result_sprites.clear();
+            Owner().generateText(0, -3 * 16, chip, result_sprites);
+            Owner().generateText(0, -2 * 16, state, result_sprites);
+            if (bench.phase() == BackupBench::Phase::Idle) return;
+
+            bn::string<64> throughput = "Read ";
+            throughput += bn::to_string<10>(bench.readBytesPerSecond());
+            throughput += " B/s  Write ";
+            throughput += bn::to_string<10>(bench.writeBytesPerSecond());
+            throughput += " B/s";
+
+            bn::string<64> erase = "Erase avg ";
+            erase += bn::to_string<10>(bench.eraseMicroseconds());
+            erase += " us";
+
+            bn::string<64> latency = "Sector ";
+            latency += bn::to_string<10>(bench.minSectorMicroseconds());
+            latency += '/';
+            latency += bn::to_string<10>(bench.avgSectorMicroseconds());
+            latency += '/';
+            latency += bn::to_string<10>(bench.maxSectorMicroseconds());
+            latency += " us";
+
+            Owner().generateText(0, -1 * 16, throughput, result_sprites);
+            Owner().generateText(0, +0 * 16, erase, result_sprites);
+            Owner().generateText(0, +1 * 16, latency, result_sprites);
+            Owner().generateText(0, +2 * 16, "min/avg/max, erase included", result_sprites);
+        }
+
+        void Update() override {
+            // The removal interrupt fires frames before the swap settles, stop writing right away
+            if (CartMonitor::removals() != removalsSeen) {
+                BackupBench::Phase phase = bench.phase();
+                if (phase == BackupBench::Phase::Reading || phase == BackupBench::Phase::Writing) {
+                    bench.abort("Cart pulled mid-test, check its save");
+                    render();
+                }
+            }
+            if (Owner().cartMonitor.generation() != cartGeneration) {
+                if (bench.phase() == BackupBench::Phase::Failed && CartMonitor::removals() != removalsSeen) {
+                    // Keep the warning up for the cart that was pulled, the next swap starts over
+                    cartGeneration = Owner().cartMonitor.generation();
+                    removalsSeen = CartMonitor::removals();
+                    render();
+                } else {
+                    restart();
+                }
+                return;
+            }
+            if (detecting) {
+                if (BackupMemory::detectStep() == BackupMemory::Scan::Done) {
+                    detecting = false;
+                    render();
+                }
+                return;
+            }
+            if (bench.phase() == BackupBench::Phase::Idle) {
+                if (bn::keypad::a_pressed() && BackupMemory::writable(BackupMemory::detectedType()) &&
+                    CartMonitor::removals() == removalsSeen) {
+                    bench.start(BackupMemory::detectedType());
+                    render();
+                }
+                return;
+            }
+            bench.run(BUDGET_CYCLES);
+            BackupBench::Phase phase = bench.phase();
+            if ((phase == BackupBench::Phase::Done || phase == BackupBench::Phase::Failed) &&
+                TestReport::claim(TestReport::KIND_BACKUP, cartGeneration)) {
+                TestReport::Line line("backup", Owner().cartMonitor.gameCode());
+                line.field("type", BackupMemory::typeName(BackupMemory::detectedType()))
+                        .field("result", phase == BackupBench::Phase::Done ? "pass" : "fail")
+                        .field("bad_sectors", bench.patternErrors())
+                        .field("read_bps", static_cast<int>(bench.readBytesPerSecond()))
+                        .field("write_bps", static_cast<int>(bench.writeBytesPerSecond()))
+                        .field("erase_us", static_cast<int>(bench.eraseMicroseconds()))
+                        .field("sector_max_us", static_cast<int>(bench.maxSectorMicroseconds()));
+                if (phase == BackupBench::Phase::Failed) line.field("reason", bench.failure());
+                line.emit();
+            }
+            if (--refreshFrames > 0) return;
+            refreshFrames = REFRESH_FRAMES;
+            render();
+        }
+
+        Transition GetTransition() override {
+            // A sector can sit erased or holding the test pattern between frames, only leave once it is restored
+            BackupBench::Phase phase = bench.phase();
+            bool running = phase == BackupBench::Phase::Reading || phase == BackupBench::Phase::Writing;
+            if (bn::keypad::select_pressed() && !running) {
+                return SiblingTransition<WelcomeScene>();
+            }
+            return NoTransition();
+        }
+
+        void OnExit() override {
+            bn::core::update();
+        }
+
+        DEFINE_HSM_STATE(BackupScene)
+    };
+    /**
+     * Sweeps the cart bus wait states one setting per frame, then applies the fastest that held up
+     */
+    struct TimingScene : BaseState {
+        bn::vector<bn::sprite_ptr, 64> text_sprites;
+        bn::vector<bn::sprite_ptr, 96> result_sprites;
+        WaitTuner::Sweep sweep;
+        bool finished = false;
+
+        void OnEnter() override {
+            text_sprites.clear();
+            Owner().generateText(0, -4 * 16, "Cart Bus Timing", text_sprites);
+            Owner().generateText(0, +2 * 16, "Defaults return when the cart is pulled", text_sprites);
+            Owner().generateText(0, +3 * 16, "A: back to default timing", text_sprites);
+            Owner().generateText(0, +4 * 16, "SELECT: back to wall clock", text_sprites);
+            finished = false;
+            sweep.start(RtcSceneManager::readStatus, RtcSceneManager::readTime);
+            render();
+        }
+
+        static void appendSetting(bn::string<64> &text, const WaitTuner::Sweep::Result &result) {
+            text += "WS0 ";
+            text += bn::to_string<2>(WaitTuner::firstAccessCycles(result.waitcnt));
+            text += '/';
+            text += bn::to_string<2>(WaitTuner::secondAccessCycles(result.waitcnt));
+            if (WaitTuner::prefetch(result.waitcnt)) text += " +PF";
+            text += ": ";
+            text += bn::to_string<8>(result.cyclesPerTransaction);
+            text += " cyc/tx";
+        }
+
+        void render() {
+            bn::string<64> baseline = "Default ";
+            appendSetting(baseline, sweep.baseline());
+
+            bn::string<64> progress;
+            bn::string<64> best;
+            if (!finished) {
+                progress = "Trying setting ";
+                progress += bn::to_string<4>(sweep.done() + 1);
+                progress += '/';
+                progress += bn::to_string<4>(WaitTuner::Sweep::SETTING_COUNT);
+            } else {
+                int stable = 0;
+                for (int i = 0; i < WaitTuner::Sweep::SETTING_COUNT; i++) {
+                    if (sweep.result(i).stable) stable++;
+                }
+                progress = bn::to_string<4>(stable);
+                progress += " of ";
+                progress += bn::to_string<4>(WaitTuner::Sweep::SETTING_COUNT);
+                progress += " settings stable";
+                int fastest = sweep.best();
+                if (fastest >= 0 && WaitTuner::tuned()) {
+                    best = "Applied ";
+                    appendSetting(best, sweep.result(fastest));
+                } else {
+                    best = "Running at default timing";
+                }
+            }
+
+            result_sprites.clear();
+            Owner().generateText(0, -2 * 16, baseline, result_sprites);
+            Owner().generateText(0, -1 * 16, progress, result_sprites);
+            Owner().generateText(0, +0 * 16, best, result_sprites);
+#ifdef LUCKY_DMA_GPIO
+            if (finished) Owner().generateText(0, +1 * 16, engines, result_sprites);
+#endif
+        }
+
+#ifdef LUCKY_DMA_GPIO
+        bn::string<64> engines;
+
+        /**
+         * Cycles per byte written through each engine at the current timing.
+         * Whole status writes are timed, so the setup knocks are shared out over the two bytes.
+         */
+        void compareEngines() {
+            static constexpr int TRANSACTIONS = 16;
+            static constexpr GpioWave::Path paths[] = {GpioWave::Path::Cpu, GpioWave::Path::Iwram,
+                                                       GpioWave::Path::Dma};
+            static constexpr const char *names[] = {"CPU ", " IWRAM ", " DMA "};
+            unsigned short status = RtcSceneManager::readStatus();
+            engines = "Cyc/byte ";
+            for (int i = 0; i < 3; i++) {
+                RtcSceneManager::busPath = paths[i];
+                unsigned start = CycleCounter::now();
+                for (int n = 0; n < TRANSACTIONS; n++) RtcSceneManager::writeStatus(status);
+                engines += names[i];
+                engines += bn::to_string<8>((CycleCounter::now() - start) / (TRANSACTIONS * 2));
+            }
+            RtcSceneManager::busPath = GpioWave::Path::Dma;
+        }
+#endif
+
+        void Update() override {
+            if (!finished && sweep.step()) {
+                finished = true;
+                int fastest = sweep.best();
+                if (fastest >= 0 && sweep.result(fastest).cyclesPerTransaction < sweep.baseline().cyclesPerTransaction) {
+                    WaitTuner::apply(sweep.result(fastest).waitcnt);
+                }
+#ifdef LUCKY_DMA_GPIO
+                compareEngines();
+#endif
+                render();
+            } else if (!finished) {
+                render();
+            } else if (bn::keypad::a_pressed() && WaitTuner::tuned()) {
+                WaitTuner::restoreDefaults();
+                render();
+            }
+        }
+
+        Transition GetTransition() override {
+            if (bn::keypad::select_pressed()) {
+                return SiblingTransition<WallClockScene>();
+            }
+            return NoTransition();
+        }
+
+        void OnExit() override {
+            bn::core::update();
+        }
+
+        DEFINE_HSM_STATE(TimingScene)
+    };
+    /**
+     * Live solar sensor level, sampled as fast as half a frame allows from IWRAM.
+     * The RTC is read between batches over the same port to show the two keep out of each other's way.
+     */
+    struct SolarScene : BaseState {
+        static constexpr unsigned BUDGET_CYCLES = 280896 / 2;
+        static constexpr int REFRESH_FRAMES = 10;
+        static constexpr int BAR_WIDTH = 20;
+
+        bn::vector<bn::sprite_ptr, 64> text_sprites;
+        bn::vector<bn::sprite_ptr, 96> result_sprites;
+        // Running average in 1/16ths of a count
+        int smoothed = 0;
+        int minimum = SolarSensor::MAX_COUNT;
+        int maximum = 0;
+        unsigned long long samples = 0;
+        unsigned long long sampleCycles = 0;
+        int rtcTime = 0;
+        bool rtcAnswered = false;
+        int refreshFrames = 0;
+
+        void OnEnter() override {
+            text_sprites.clear();
+            Owner().generateText(0, -4 * 16, "Solar Sensor", text_sprites);
+            Owner().generateText(0, +3 * 16, "Cover or light the sensor to test it", text_sprites);
+            Owner().generateText(0, +4 * 16, "SELECT: back to status", text_sprites);
+            CycleCounter::ensureRunning();
+            smoothed = SolarSensor::sample() << 4;
+            minimum = SolarSensor::MAX_COUNT;
+            maximum = 0;
+            samples = 0;
+            sampleCycles = 0;
+            refreshFrames = 0;
+        }
+
+        void render() {
+            int average = smoothed >> 4;
+            bn::string<64> level = "Light ";
+            level += bn::to_string<4>(SolarSensor::lightPercent(average));
+            level += "%  [";
+            int filled = SolarSensor::lightPercent(average) * BAR_WIDTH / 100;
+            for (int i = 0; i < BAR_WIDTH; i++) level += i < filled ? '#' : '.';
+            level += ']';
+
+            bn::string<64> raw = "Count ";
+            raw += bn::to_string<4>(average);
+            raw += " (min ";
+            raw += bn::to_string<4>(minimum);
+            raw += ", max ";
+            raw += bn::to_string<4>(maximum);
+            raw += ")";
+
+            bn::string<64> rate = "Samples/s ";
+            rate += bn::to_string<10>(sampleCycles ? static_cast<unsigned>(
+                    samples * CycleCounter::CYCLES_PER_SECOND / sampleCycles) : 0);
+
+            bn::string<64> rtc = "RTC on the same port:";
+            if (rtcAnswered) {
+                RtcFormat::appendTime(rtc, RtcFormat::fromBcd(rtcTime & 0x3F), RtcFormat::fromBcd(rtcTime >> 8 & 0x7F),
+                                      RtcFormat::fromBcd(rtcTime >> 16 & 0x7F), false);
+            } else {
+                rtc += " no answer";
+            }
+
+            result_sprites.clear();
+            Owner().generateText(0, -2 * 16, level, result_sprites);
+            Owner().generateText(0, -1 * 16, raw, result_sprites);
+            Owner().generateText(0, +0 * 16, rate, result_sprites);
+            Owner().generateText(0, +1 * 16, rtc, result_sprites);
+        }
+
+        void Update() override {
+            unsigned begin = CycleCounter::now();
+            int total = 0, count = 0;
+            while (CycleCounter::now() - begin < BUDGET_CYCLES) {
+                int value = SolarSensor::sample();
+                if (value < minimum) minimum = value;
+                if (value > maximum) maximum = value;
+                total += value;
+                count++;
+            }
+            sampleCycles += CycleCounter::now() - begin;
+            samples += count;
+            // Each frame's mean moves the display an eighth of the way
+            smoothed += ((total << 4) / count - smoothed) / 8;
+
+            // Chip select went low with every sample, the RTC routines raise it again themselves
+            rtcTime = RtcSceneManager::readTime();
+            rtcAnswered = rtcTime != 0xFFFFFF;
+
+            if (--refreshFrames > 0) return;
+            refreshFrames = REFRESH_FRAMES;
+            render();
+        }
+
+        Transition GetTransition() override {
+            if (bn::keypad::select_pressed()) {
+                return SiblingTransition<StatusScene>();
+            }
+            return NoTransition();
+        }
+
+        void OnExit() override {
+            bn::core::update();
+        }
+
+        DEFINE_HSM_STATE(SolarScene)
+    };
 };
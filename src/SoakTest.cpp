@@ -0,0 +1,158 @@
+#include "SoakTest.h"
+
+#include "CycleCounter.h"
+
+// Bits of each datetime byte that carry the value, the rest are flags
+static constexpr unsigned FIELD_MASKS[] = {0x7F, 0xFF, 0x1F, 0x3F, 0x07, 0x3F, 0x7F, 0x7F};
+// Valid range of each datetime byte once masked
+static constexpr int FIELD_MIN[] = {0, 0, 1, 1, 0, 0, 0, 0};
+static constexpr int FIELD_MAX[] = {0, 99, 12, 31, 6, 23, 59, 59};
+
+#define STATUS_POWER 0x80
+#define STATUS_24H 0x40
+
+static int popcount(unsigned value) {
+    return __builtin_popcount(value);
+}
+
+static bool validBcd(unsigned bcd, int min, int max) {
+    if ((bcd & 0xF) > 9 || (bcd >> 4) > 9) return false;
+    int value = RtcFormat::fromBcd(bcd);
+    return min <= value && value <= max;
+}
+
+void SoakTest::start(const Bus &value) {
+    *this = SoakTest();
+    bus = value;
+    if (bus.removals) removalsAtStart = bus.removals();
+    CycleCounter::ensureRunning();
+    lastStamp = CycleCounter::now();
+
+    baselineStatus = bus.readStatus();
+    twelveHour = !(baselineStatus & STATUS_24H);
+    powerRaised = baselineStatus & STATUS_POWER;
+    unsigned char bcd[7];
+    bus.readDateTime(bcd);
+    savedTime = RtcFormat::decodeDateTime(bcd, twelveHour);
+    active = true;
+}
+
+void SoakTest::run(unsigned budgetCycles) {
+    if (!active) return;
+    unsigned begin = CycleCounter::now();
+    elapsedCycles += begin - lastStamp;
+    lastStamp = begin;
+    if (!budgetCycles) return;
+    while (CycleCounter::now() - begin < budgetCycles) {
+        if (bus.removals && bus.removals() != removalsAtStart) {
+            abandon();
+            break;
+        }
+        switch (step) {
+            case 0:
+                checkStatus();
+                break;
+            case 1:
+                checkDateTime();
+                break;
+            default:
+                checkWriteReadback();
+                break;
+        }
+        step = (step + 1) % 3;
+    }
+    activeCycles += CycleCounter::now() - begin;
+}
+
+void SoakTest::abandon() {
+    if (!active) return;
+    active = false;
+    cartLost = true;
+}
+
+void SoakTest::finish() {
+    if (!active) return;
+    active = false;
+    RtcFormat::DateTime restored = savedTime;
+    RtcFormat::addSeconds(restored, elapsedSeconds());
+    bus.writeStatus(baselineStatus & ~STATUS_POWER);
+    write(restored);
+}
+
+unsigned SoakTest::elapsedSeconds() const {
+    return static_cast<unsigned>(elapsedCycles / CycleCounter::CYCLES_PER_SECOND);
+}
+
+unsigned SoakTest::transactionsPerSecond() const {
+    if (!activeCycles) return 0;
+    return static_cast<unsigned>(transactionCount * static_cast<unsigned long long>(CycleCounter::CYCLES_PER_SECOND)
+                                 / activeCycles);
+}
+
+void SoakTest::compare(Field field, unsigned expected, unsigned actual, unsigned mask) {
+    int wrong = popcount((expected ^ actual) & mask);
+    checkedBits += popcount(mask);
+    errorBits += wrong;
+    if (wrong) fieldFailures[field]++;
+}
+
+void SoakTest::checkStatus() {
+    int status = bus.readStatus();
+    transactionCount++;
+    bool power = status & STATUS_POWER;
+    if (power && !powerRaised) powerRaises++;
+    powerRaised = power;
+    compare(FIELD_STATUS, baselineStatus, status, 0x7F);
+}
+
+void SoakTest::checkDateTime() {
+    unsigned char bcd[7];
+    bus.readDateTime(bcd);
+    transactionCount++;
+    // Nothing to compare against, but every field has to be a legal value
+    for (int i = 0; i < 7; i++) {
+        auto field = static_cast<Field>(FIELD_YEAR + i);
+        int max = FIELD_MAX[field];
+        if (field == FIELD_HOUR && twelveHour) max = 11;
+        if (!validBcd(bcd[i] & FIELD_MASKS[field], FIELD_MIN[field], max)) fieldFailures[field]++;
+    }
+}
+
+void SoakTest::checkWriteReadback() {
+    // Cheap LCG walks every field through its range without repeating a neighbour
+    seed = seed * 1664525 + 1013904223;
+    unsigned pattern = seed >> 8;
+    RtcFormat::DateTime expected;
+    expected.year = static_cast<int>(pattern % 100);
+    expected.month = static_cast<int>(pattern / 100 % 12) + 1;
+    expected.day = static_cast<int>(pattern / 1200 % 28) + 1;
+    expected.weekDay = static_cast<int>(pattern % 7);
+    expected.hour = static_cast<int>(pattern / 7 % 24);
+    expected.minute = static_cast<int>(pattern / 168 % 60);
+    // Stay clear of 59 so a tick between write and read cannot carry into the minute
+    expected.second = static_cast<int>(pattern / 10080 % 59);
+    write(expected);
+
+    unsigned char bcd[7];
+    bus.readDateTime(bcd);
+    transactionCount += 2;
+
+    compare(FIELD_YEAR, RtcFormat::toBcd(expected.year), bcd[0], FIELD_MASKS[FIELD_YEAR]);
+    compare(FIELD_MONTH, RtcFormat::toBcd(expected.month), bcd[1], FIELD_MASKS[FIELD_MONTH]);
+    compare(FIELD_DAY, RtcFormat::toBcd(expected.day), bcd[2], FIELD_MASKS[FIELD_DAY]);
+    compare(FIELD_WEEKDAY, expected.weekDay, bcd[3], FIELD_MASKS[FIELD_WEEKDAY]);
+    int hour = twelveHour ? expected.hour % 12 : expected.hour;
+    compare(FIELD_HOUR, RtcFormat::toBcd(hour), bcd[4], FIELD_MASKS[FIELD_HOUR]);
+    compare(FIELD_MINUTE, RtcFormat::toBcd(expected.minute), bcd[5], FIELD_MASKS[FIELD_MINUTE]);
+    // A second may legitimately have ticked over
+    unsigned second = bcd[6] & FIELD_MASKS[FIELD_SECOND];
+    unsigned later = RtcFormat::toBcd(expected.second + 1);
+    compare(FIELD_SECOND, second == later ? later : RtcFormat::toBcd(expected.second), second,
+            FIELD_MASKS[FIELD_SECOND]);
+}
+
+void SoakTest::write(const RtcFormat::DateTime &dateTime) {
+    int hour = twelveHour ? dateTime.hour % 12 : dateTime.hour;
+    bus.setDateTime(dateTime.year, dateTime.month, dateTime.day, dateTime.weekDay, hour, dateTime.minute,
+                    dateTime.second, dateTime.hour >= 12);
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "RtcFormat.h"
+
+/**
+ * Stress test of the RTC bus for incoming cart QA.
+ * Cycles through status reads, datetime reads and write/readback of varied datetimes, a frame budget at a time,
+ * counting every bit that came back different from what was expected.
+ * The clock and status found at the start are put back, moved on by however long the test ran,
+ * unless the cart was pulled on the way: then the test stops dead and nothing is written to whatever replaced it.
+ */
+class SoakTest {
+public:
+    /**
+     * The bit-banged routines to exercise, see RtcSceneManager
+     */
+    struct Bus {
+        int (*readStatus)();
+
+        void (*writeStatus)(unsigned short status);
+
+        // Seven BCD bytes, year first, as they come off the wire
+        void (*readDateTime)(unsigned char *bcd);
+
+        void (*setDateTime)(int year, int month, int day, int dayOfWeek, int hour, int minute, int second,
+                            bool afternoon);
+
+        // Moves whenever the cart is pulled, see CartMonitor::removals. Optional.
+        unsigned (*removals)();
+    };
+
+    enum Field : unsigned char {
+        FIELD_STATUS,
+        FIELD_YEAR,
+        FIELD_MONTH,
+        FIELD_DAY,
+        FIELD_WEEKDAY,
+        FIELD_HOUR,
+        FIELD_MINUTE,
+        FIELD_SECOND,
+        FIELD_COUNT
+    };
+
+    void start(const Bus &value);
+
+    /**
+     * Runs operations until the budget is spent, call once per frame. A zero budget only keeps time, e.g. while paused.
+     */
+    void run(unsigned budgetCycles);
+
+    /**
+     * Restores the clock and status found by start. Safe to call more than once, does nothing once abandoned.
+     */
+    void finish();
+
+    /**
+     * Stops without touching the bus again, for when the cart in the slot is no longer the one tested
+     */
+    void abandon();
+
+    [[nodiscard]] bool running() const {
+        return active;
+    }
+
+    [[nodiscard]] bool abandoned() const {
+        return cartLost;
+    }
+
+    [[nodiscard]] unsigned transactions() const {
+        return transactionCount;
+    }
+
+    [[nodiscard]] unsigned transactionsPerSecond() const;
+
+    [[nodiscard]] unsigned elapsedSeconds() const;
+
+    [[nodiscard]] unsigned bitsChecked() const {
+        return checkedBits;
+    }
+
+    [[nodiscard]] unsigned bitErrors() const {
+        return errorBits;
+    }
+
+    /**
+     * Failed readings of one field, a reading fails on any wrong bit or an out of range value
+     */
+    [[nodiscard]] unsigned fieldErrors(Field field) const {
+        return fieldFailures[field];
+    }
+
+    /**
+     * Times the power flag came up during the test, it should never rise on a healthy cart
+     */
+    [[nodiscard]] unsigned powerFlagRaises() const {
+        return powerRaises;
+    }
+
+private:
+    Bus bus{};
+    bool active = false;
+    bool twelveHour = false;
+    bool powerRaised = false;
+    bool cartLost = false;
+    unsigned removalsAtStart = 0;
+    int baselineStatus = 0;
+    RtcFormat::DateTime savedTime;
+    int step = 0;
+    unsigned seed = 1;
+
+    unsigned lastStamp = 0;
+    // Wall time for putting the clock back, and time spent testing for the rate
+    unsigned long long elapsedCycles = 0;
+    unsigned long long activeCycles = 0;
+
+    unsigned transactionCount = 0;
+    unsigned checkedBits = 0;
+    unsigned errorBits = 0;
+    unsigned powerRaises = 0;
+    unsigned fieldFailures[FIELD_COUNT]{};
+
+    void checkStatus();
+
+    void checkDateTime();
+
+    void checkWriteReadback();
+
+    void compare(Field field, unsigned expected, unsigned actual, unsigned mask);
+
+    void write(const RtcFormat::DateTime &dateTime);
+};
@@ -0,0 +1,26 @@
+#include "SoftClock.h"
+
+#include "CycleCounter.h"
+
+void SoftClock::start(const RtcFormat::DateTime &reference) {
+    CycleCounter::ensureRunning();
+    base = reference;
+    lastRaw = CycleCounter::now();
+    elapsedCycles = 0;
+}
+
+void SoftClock::update() {
+    unsigned raw = CycleCounter::now();
+    elapsedCycles += raw - lastRaw;
+    lastRaw = raw;
+}
+
+unsigned SoftClock::elapsedSeconds() const {
+    return static_cast<unsigned>(elapsedCycles / CycleCounter::CYCLES_PER_SECOND);
+}
+
+RtcFormat::DateTime SoftClock::now() const {
+    RtcFormat::DateTime current = base;
+    RtcFormat::addSeconds(current, elapsedSeconds());
+    return current;
+}
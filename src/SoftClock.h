@@ -0,0 +1,26 @@
+#pragma once
+
+#include "RtcFormat.h"
+
+/**
+ * Keeps a reference datetime ticking off the system clock, so many carts can be set to the same time
+ * without any one of them having to stay in the slot.
+ */
+class SoftClock {
+public:
+    void start(const RtcFormat::DateTime &reference);
+
+    /**
+     * Call at least once a frame, the underlying counter wraps every 256 seconds
+     */
+    void update();
+
+    [[nodiscard]] RtcFormat::DateTime now() const;
+
+    [[nodiscard]] unsigned elapsedSeconds() const;
+
+private:
+    RtcFormat::DateTime base;
+    unsigned lastRaw = 0;
+    unsigned long long elapsedCycles = 0;
+};
@@ -0,0 +1,26 @@
+#include "SolarSensor.h"
+
+#define GPIO_DAT *((volatile unsigned short *)0x080000C4)
+#define GPIO_DIR *((volatile unsigned short *)0x080000C6)
+#define GPIO_CTL *((volatile unsigned short *)0x080000C8)
+
+#define SOLAR_CLOCK 0b0001
+#define SOLAR_RESET 0b0010
+#define SOLAR_FLAG 0b1000
+
+namespace SolarSensor {
+    int sample() {
+        GPIO_CTL = 0b001;
+        // Bits 0-2 out, comparator in
+        GPIO_DIR = 0b0111;
+        GPIO_DAT = SOLAR_RESET;
+        GPIO_DAT = 0;
+        int count = 0;
+        while (count < MAX_COUNT && !(GPIO_DAT & SOLAR_FLAG)) {
+            GPIO_DAT = SOLAR_CLOCK;
+            GPIO_DAT = 0;
+            count++;
+        }
+        return count;
+    }
+}
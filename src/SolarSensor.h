@@ -0,0 +1,26 @@
+#pragma once
+
+#include "bn_common.h"
+
+/**
+ * Boktai solar sensor, which shares the cart GPIO port with the RTC.
+ * DAT bit 0 clocks a counter, bit 1 resets it, bit 2 is the RTC chip select (held low while sampling so the
+ * RTC ignores us) and bit 3 reads back the comparator, which trips once the counter passes the light level.
+ * Fewer clocks before the trip means more light.
+ */
+namespace SolarSensor {
+    // Counter value when the comparator never tripped: pitch dark, or no sensor on the port
+    constexpr int MAX_COUNT = 255;
+
+    /**
+     * One full count, leaves the port with every output low so the next RTC access starts clean
+     */
+    BN_CODE_IWRAM int sample();
+
+    /**
+     * 0 in the dark, 100 in full sunlight
+     */
+    [[nodiscard]] inline int lightPercent(int count) {
+        return (MAX_COUNT - count) * 100 / MAX_COUNT;
+    }
+}
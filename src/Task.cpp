@@ -0,0 +1,53 @@
+#include "Task.h"
+
+#include <utility>
+
+#include "bn_common.h"
+
+#include "CycleCounter.h"
+
+namespace Task {
+    struct FrameSlot {
+        alignas(8) unsigned char bytes[FRAME_SLOT_SIZE];
+    };
+
+    BN_DATA_EWRAM_BSS static FrameSlot slots[FRAME_SLOTS];
+    static bool slotUsed[FRAME_SLOTS];
+
+    static unsigned sliceStart = 0;
+    static unsigned sliceBudget = 0;
+
+    void *Job::promise_type::operator new(std::size_t size) noexcept {
+        BN_ASSERT(size <= FRAME_SLOT_SIZE, "Task frame too big: ", int(size));
+        for (int i = 0; i < FRAME_SLOTS; i++) {
+            if (slotUsed[i]) continue;
+            slotUsed[i] = true;
+            return slots[i].bytes;
+        }
+        return nullptr;
+    }
+
+    void Job::promise_type::operator delete(void *frame) noexcept {
+        for (int i = 0; i < FRAME_SLOTS; i++) {
+            if (slots[i].bytes == frame) slotUsed[i] = false;
+        }
+    }
+
+    bool overBudget() {
+        return CycleCounter::now() - sliceStart >= sliceBudget;
+    }
+
+    bool Runner::start(Job &&value) {
+        job = std::move(value);
+        return job.valid();
+    }
+
+    void Runner::run(unsigned budgetCycles) {
+        CycleCounter::ensureRunning();
+        sliceStart = CycleCounter::now();
+        sliceBudget = budgetCycles;
+        job.resume();
+        // Free the frame as soon as it is finished rather than when the next job comes along
+        if (job.done()) job.reset();
+    }
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+
+#include "bn_assert.h"
+
+/**
+ * Coroutine jobs for bus sequences that span frames, e.g. a reset followed by polling or a write and its verify.
+ * A job is written top to bottom and gives the frame back at `co_await Task::nextFrame()`, or at
+ * `co_await Task::checkpoint()` once the slice handed to Runner::run is used up.
+ * Frames come out of a small fixed pool, there is no heap behind them.
+ */
+namespace Task {
+    constexpr int FRAME_SLOTS = 2;
+    constexpr int FRAME_SLOT_SIZE = 256;
+
+    class Job {
+    public:
+        struct promise_type {
+            static void *operator new(std::size_t size) noexcept;
+
+            static void operator delete(void *frame) noexcept;
+
+            /**
+             * Pool exhausted, the caller gets a job that never runs
+             */
+            static Job get_return_object_on_allocation_failure() {
+                return {};
+            }
+
+            Job get_return_object() {
+                return Job(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept {
+                return {};
+            }
+
+            std::suspend_always final_suspend() noexcept {
+                return {};
+            }
+
+            void return_void() {
+            }
+
+            void unhandled_exception() {
+                BN_ERROR("Exception in task");
+            }
+        };
+
+        Job() = default;
+
+        Job(Job &&other) noexcept: handle(other.handle) {
+            other.handle = nullptr;
+        }
+
+        Job &operator=(Job &&other) noexcept {
+            if (this != &other) {
+                reset();
+                handle = other.handle;
+                other.handle = nullptr;
+            }
+            return *this;
+        }
+
+        ~Job() {
+            reset();
+        }
+
+        [[nodiscard]] bool valid() const {
+            return bool(handle);
+        }
+
+        [[nodiscard]] bool done() const {
+            return !handle || handle.done();
+        }
+
+        void resume() {
+            if (!done()) handle.resume();
+        }
+
+        void reset() {
+            if (handle) handle.destroy();
+            handle = nullptr;
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+
+        explicit Job(std::coroutine_handle<promise_type> value) : handle(value) {
+        }
+    };
+
+    /**
+     * True once the current slice has used its cycles
+     */
+    [[nodiscard]] bool overBudget();
+
+    struct NextFrame {
+        [[nodiscard]] bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<>) const noexcept {
+        }
+
+        void await_resume() const noexcept {
+        }
+    };
+
+    struct Checkpoint {
+        [[nodiscard]] bool await_ready() const noexcept {
+            return !overBudget();
+        }
+
+        void await_suspend(std::coroutine_handle<>) const noexcept {
+        }
+
+        void await_resume() const noexcept {
+        }
+    };
+
+    /**
+     * Always yields, the job picks up again on the next Runner::run
+     */
+    inline NextFrame nextFrame() {
+        return {};
+    }
+
+    /**
+     * Only yields when the slice is spent, cheap enough to sprinkle between bus transactions
+     */
+    inline Checkpoint checkpoint() {
+        return {};
+    }
+
+    /**
+     * Owns one job and resumes it once per frame
+     */
+    class Runner {
+    public:
+        /**
+         * Replaces whatever was running, false when the job could not get a frame
+         */
+        bool start(Job &&value);
+
+        /**
+         * Resumes the job until it yields or finishes, call once per frame
+         */
+        void run(unsigned budgetCycles);
+
+        void cancel() {
+            job.reset();
+        }
+
+        [[nodiscard]] bool running() const {
+            return !job.done();
+        }
+
+    private:
+        Job job;
+    };
+}
@@ -0,0 +1,121 @@
+#include "TestReport.h"
+
+#define REG_DEBUG_ENABLE *((volatile unsigned short *)0x04FFF780)
+#define REG_DEBUG_FLAGS *((volatile unsigned short *)0x04FFF700)
+#define REG_DEBUG_STRING ((volatile char *)0x04FFF600)
+#define DEBUG_ENABLE_REQUEST 0xC0DE
+#define DEBUG_ENABLED 0x1DEA
+#define DEBUG_SEND 0x100
+#define DEBUG_LEVEL_INFO 3
+#define DEBUG_STRING_SIZE 256
+
+#define REG_RCNT *((volatile unsigned short *)0x04000134)
+#define REG_SIOCNT *((volatile unsigned short *)0x04000128)
+#define REG_SIODATA8 *((volatile unsigned char *)0x0400012A)
+// UART mode, 115200 baud, 8 bit data, send enabled, CTS ignored
+#define SIO_UART 0x3000
+#define SIO_115200 0x0003
+#define SIO_8BIT 0x0080
+#define SIO_SEND_ENABLE 0x0400
+#define SIO_SEND_FULL 0x0010
+// A byte takes under 90 us at 115200, give up well after that
+#define SIO_SPIN_LIMIT 20000
+
+namespace TestReport {
+    static Transport active = Transport::Uart;
+    static unsigned claimed[KIND_COUNT];
+    static bool anyClaimed[KIND_COUNT];
+
+    void init() {
+        REG_DEBUG_ENABLE = DEBUG_ENABLE_REQUEST;
+        if (REG_DEBUG_ENABLE == DEBUG_ENABLED) {
+            active = Transport::Mgba;
+            return;
+        }
+        active = Transport::Uart;
+        REG_RCNT = 0;
+        REG_SIOCNT = SIO_UART | SIO_115200 | SIO_8BIT | SIO_SEND_ENABLE;
+    }
+
+    Transport transport() {
+        return active;
+    }
+
+    bool claim(Kind kind, unsigned cartGeneration) {
+        if (anyClaimed[kind] && claimed[kind] == cartGeneration) return false;
+        anyClaimed[kind] = true;
+        claimed[kind] = cartGeneration;
+        return true;
+    }
+
+    static void sendUart(char c) {
+        for (int spin = 0; REG_SIOCNT & SIO_SEND_FULL; spin++) {
+            if (spin == SIO_SPIN_LIMIT) return;
+        }
+        REG_SIODATA8 = static_cast<unsigned char>(c);
+    }
+
+    Line::Line(const char *kind, unsigned gameCode) {
+        text = "LRTC1 kind=";
+        text += kind;
+        key("cart");
+        for (int i = 0; i < 4; i++) {
+            char c = static_cast<char>(gameCode >> (i * 8));
+            // Empty slots read as open bus, keep the line parseable
+            text += ' ' < c && c <= '~' ? c : '_';
+        }
+    }
+
+    void Line::key(const char *name) {
+        text += ' ';
+        text += name;
+        text += '=';
+    }
+
+    Line &Line::field(const char *name, const bn::string_view &value) {
+        key(name);
+        for (char c: value) text += c == ' ' ? '_' : c;
+        return *this;
+    }
+
+    Line &Line::field(const char *name, int value) {
+        key(name);
+        text += bn::to_string<12>(value);
+        return *this;
+    }
+
+    Line &Line::hex(const char *name, unsigned value, int digits) {
+        key(name);
+        for (int shift = (digits - 1) * 4; shift >= 0; shift -= 4) text += "0123456789ABCDEF"[(value >> shift) & 0xF];
+        return *this;
+    }
+
+    Line &Line::bcd(const char *name, unsigned packed, int count, char separator, const char *prefix) {
+        key(name);
+        text += prefix;
+        for (int i = 0; i < count; i++) {
+            if (i) text += separator;
+            unsigned digits = (packed >> (i * 8)) & 0xFF;
+            text += static_cast<char>('0' + ((digits >> 4) & 0xF));
+            text += static_cast<char>('0' + (digits & 0xF));
+        }
+        return *this;
+    }
+
+    void send(const bn::string_view &line) {
+        if (active == Transport::Mgba) {
+            int length = line.size() < DEBUG_STRING_SIZE - 1 ? line.size() : DEBUG_STRING_SIZE - 1;
+            for (int i = 0; i < length; i++) REG_DEBUG_STRING[i] = line[i];
+            REG_DEBUG_STRING[length] = 0;
+            REG_DEBUG_FLAGS = DEBUG_SEND | DEBUG_LEVEL_INFO;
+            return;
+        }
+        for (char c: line) sendUart(c);
+        sendUart('\r');
+        sendUart('\n');
+    }
+
+    void Line::emit() {
+        send(text);
+    }
+}
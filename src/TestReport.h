@@ -0,0 +1,61 @@
+#pragma once
+
+#include "bn_string.h"
+#include "bn_string_view.h"
+
+/**
+ * Machine readable results for test rigs, one line per result and at most one result of each kind per cart:
+ *     LRTC1 kind=status cart=BPEE sig=1A2B status=40 class=ok date=2024-05-01 time=12:34:56
+ * Lines go to the mGBA debug log when running under mGBA, otherwise out of the link port in UART mode
+ * (115200 8N1, no flow control) for a USB serial adapter to pick up.
+ */
+namespace TestReport {
+    enum class Transport : unsigned char {
+        Mgba, Uart
+    };
+
+    enum Kind : unsigned char {
+        KIND_STATUS,
+        KIND_PROVISION,
+        KIND_SOAK,
+        KIND_BACKUP,
+        KIND_COUNT
+    };
+
+    void init();
+
+    [[nodiscard]] Transport transport();
+
+    /**
+     * True the first time a kind is reported for a cart, false for repeats that should stay quiet
+     */
+    bool claim(Kind kind, unsigned cartGeneration);
+
+    /**
+     * Sends one line as is over the active transport, for bulk output that does not fit the kind=... format
+     */
+    void send(const bn::string_view &line);
+
+    class Line {
+    public:
+        Line(const char *kind, unsigned gameCode);
+
+        Line &field(const char *key, const bn::string_view &value);
+
+        Line &field(const char *key, int value);
+
+        Line &hex(const char *key, unsigned value, int digits);
+
+        /**
+         * Two digit BCD fields joined with a separator, e.g. a packed date or time off the RTC
+         */
+        Line &bcd(const char *key, unsigned packed, int count, char separator, const char *prefix);
+
+        void emit();
+
+    private:
+        bn::string<224> text;
+
+        void key(const char *name);
+    };
+}
@@ -0,0 +1,36 @@
+#include "TextQueue.h"
+
+#include "CycleCounter.h"
+
+bool TextQueue::push(bn::fixed x, bn::fixed y, const bn::string_view &text, bn::ivector<bn::sprite_ptr> &sprites,
+                     Priority priority) {
+    if (jobs.full() || text.size() > MAX_LINE) return false;
+    // Blank lines cost nothing to skip now
+    if (text.empty()) return true;
+    jobs.push_back(Job{x, y, bn::string<MAX_LINE>(text), &sprites, priority});
+    return true;
+}
+
+void TextQueue::discard(const bn::ivector<bn::sprite_ptr> &sprites) {
+    bn::erase_if(jobs, [&sprites](const Job &job) {
+        return job.sprites == &sprites;
+    });
+}
+
+int TextQueue::drain(bn::sprite_text_generator &generator, unsigned budgetCycles) {
+    if (jobs.empty()) return 0;
+    CycleCounter::ensureRunning();
+    unsigned start = CycleCounter::now();
+    int generated = 0;
+    do {
+        // Jobs are in queue order, so the first of the best priority is also the oldest
+        auto next = jobs.begin();
+        for (auto job = jobs.begin(); job != jobs.end(); ++job) {
+            if (job->priority < next->priority) next = job;
+        }
+        generator.generate(next->x, next->y, next->text, *next->sprites);
+        jobs.erase(next);
+        generated++;
+    } while (!jobs.empty() && CycleCounter::now() - start < budgetCycles);
+    return generated;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "bn_fixed.h"
+#include "bn_sprite_ptr.h"
+#include "bn_sprite_text_generator.h"
+#include "bn_string.h"
+#include "bn_vector.h"
+
+/**
+ * Spreads sprite text generation over the frames after a scene change instead of paying for every line at once.
+ * Lines are generated most important first, oldest first within a priority, until the frame's budget is spent.
+ * At least one line goes out per frame so the queue always drains, and no line is longer than MAX_LINE, so the
+ * cost of a frame stays bounded however much text a scene puts up.
+ */
+class TextQueue {
+public:
+    static constexpr int CAPACITY = 16;
+    static constexpr int MAX_LINE = 64;
+
+    enum class Priority : unsigned char {
+        High, Normal, Low
+    };
+
+    /**
+     * False when the line can't be queued (full, or too long) and should be generated straight away
+     */
+    bool push(bn::fixed x, bn::fixed y, const bn::string_view &text, bn::ivector<bn::sprite_ptr> &sprites,
+              Priority priority);
+
+    /**
+     * Drops pending lines bound for sprites that are about to be cleared or destroyed
+     */
+    void discard(const bn::ivector<bn::sprite_ptr> &sprites);
+
+    /**
+     * Call once per frame, returns how many lines were generated
+     */
+    int drain(bn::sprite_text_generator &generator, unsigned budgetCycles);
+
+    [[nodiscard]] bool empty() const {
+        return jobs.empty();
+    }
+
+private:
+    struct Job {
+        bn::fixed x;
+        bn::fixed y;
+        bn::string<MAX_LINE> text;
+        bn::ivector<bn::sprite_ptr> *sprites;
+        Priority priority;
+    };
+
+    bn::vector<Job, CAPACITY> jobs;
+};
@@ -0,0 +1,113 @@
+#include "WaitTuner.h"
+
+#include "CycleCounter.h"
+
+#define REG_WAITCNT *((volatile unsigned short *)0x04000204)
+#define ROM_HEADER ((volatile unsigned *)0x080000A0)
+
+// WS0 first access in bits 2-3, second access in bit 4, prefetch in bit 14
+#define WS0_MASK 0x001C
+#define WS0_FIRST_SHIFT 2
+#define WS0_SECOND 0x0010
+#define PREFETCH 0x4000
+
+// Status reads timed per setting
+#define SAMPLES 32
+
+namespace WaitTuner {
+    static unsigned short defaultWaitcnt = 0;
+    static volatile bool applied = false;
+
+    // Index is the register field value
+    static constexpr int FIRST_CYCLES[] = {4, 3, 2, 8};
+
+    void captureDefaults() {
+        defaultWaitcnt = REG_WAITCNT;
+    }
+
+    void restoreDefaults() {
+        REG_WAITCNT = defaultWaitcnt;
+        applied = false;
+    }
+
+    bool tuned() {
+        return applied;
+    }
+
+    void apply(unsigned short waitcnt) {
+        REG_WAITCNT = waitcnt;
+        applied = waitcnt != defaultWaitcnt;
+    }
+
+    unsigned short current() {
+        return REG_WAITCNT;
+    }
+
+    int firstAccessCycles(unsigned short waitcnt) {
+        return FIRST_CYCLES[(waitcnt >> WS0_FIRST_SHIFT) & 0x3];
+    }
+
+    int secondAccessCycles(unsigned short waitcnt) {
+        return waitcnt & WS0_SECOND ? 1 : 2;
+    }
+
+    bool prefetch(unsigned short waitcnt) {
+        return waitcnt & PREFETCH;
+    }
+
+    static bool validBcd(int value, int max) {
+        return (value & 0xF) <= 9 && (value >> 4 & 0xF) <= 9 && (value >> 4) * 10 + (value & 0xF) <= max;
+    }
+
+    void Sweep::start(StatusReader status, TimeReader time) {
+        CycleCounter::ensureRunning();
+        readStatus = status;
+        readTime = time;
+        next = 0;
+        restoreDefaults();
+        for (int i = 0; i < 8; i++) header[i] = ROM_HEADER[i];
+        expectedStatus = readStatus();
+        defaultResult = measure(defaultWaitcnt);
+    }
+
+    Sweep::Result Sweep::measure(unsigned short waitcnt) {
+        Result result{waitcnt, 0, true};
+        REG_WAITCNT = waitcnt;
+
+        for (int i = 0; i < 8; i++) {
+            if (ROM_HEADER[i] != header[i]) result.stable = false;
+        }
+        unsigned start = CycleCounter::now();
+        for (int i = 0; i < SAMPLES; i++) {
+            if (readStatus() != expectedStatus) result.stable = false;
+        }
+        result.cyclesPerTransaction = (CycleCounter::now() - start) / SAMPLES;
+        // Time keeps moving, so only ask that it still reads as a time
+        int time = readTime();
+        if (!validBcd(time & 0x3F, 23) || !validBcd(time >> 8 & 0x7F, 59) || !validBcd(time >> 16 & 0x7F, 59)) {
+            result.stable = false;
+        }
+
+        REG_WAITCNT = defaultWaitcnt;
+        return result;
+    }
+
+    bool Sweep::step() {
+        if (next == SETTING_COUNT) return true;
+        unsigned short waitcnt = defaultWaitcnt & ~(WS0_MASK | PREFETCH);
+        waitcnt |= (next & 0x3) << WS0_FIRST_SHIFT;
+        if (next & 0x4) waitcnt |= WS0_SECOND;
+        if (next & 0x8) waitcnt |= PREFETCH;
+        results[next] = measure(waitcnt);
+        return ++next == SETTING_COUNT;
+    }
+
+    int Sweep::best() const {
+        int fastest = -1;
+        for (int i = 0; i < next; i++) {
+            if (!results[i].stable) continue;
+            if (fastest < 0 || results[i].cyclesPerTransaction < results[fastest].cyclesPerTransaction) fastest = i;
+        }
+        return fastest;
+    }
+}
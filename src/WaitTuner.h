@@ -0,0 +1,85 @@
+#pragma once
+
+/**
+ * Cart bus timing (WAITCNT) tuning. The RTC GPIO registers sit in the WS0 ROM region, so every
+ * knock on the bus pays its wait states. A sweep runs each WS0 timing and prefetch combination against the
+ * inserted cart, validating header and RTC reads, and the fastest one that held up can then be applied.
+ * WS2 is left alone: nothing on the RTC path goes through it and EEPROM saves need it slow.
+ * Defaults go back on as soon as the cart is pulled.
+ */
+namespace WaitTuner {
+    /**
+     * Remembers the boot value as the safe default, call once after the framework is up
+     */
+    void captureDefaults();
+
+    /**
+     * Safe to call from an interrupt handler
+     */
+    void restoreDefaults();
+
+    [[nodiscard]] bool tuned();
+
+    void apply(unsigned short waitcnt);
+
+    [[nodiscard]] unsigned short current();
+
+    [[nodiscard]] int firstAccessCycles(unsigned short waitcnt);
+
+    [[nodiscard]] int secondAccessCycles(unsigned short waitcnt);
+
+    [[nodiscard]] bool prefetch(unsigned short waitcnt);
+
+    class Sweep {
+    public:
+        // 4 first access timings x 2 second access timings x prefetch off/on
+        static constexpr int SETTING_COUNT = 16;
+
+        struct Result {
+            unsigned short waitcnt;
+            unsigned cyclesPerTransaction;
+            bool stable;
+        };
+
+        using StatusReader = int (*)();
+        using TimeReader = int (*)();
+
+        void start(StatusReader status, TimeReader time);
+
+        /**
+         * Tries one setting, call once per frame until it returns true
+         */
+        bool step();
+
+        [[nodiscard]] int done() const {
+            return next;
+        }
+
+        [[nodiscard]] const Result &result(int index) const {
+            return results[index];
+        }
+
+        /**
+         * Fastest stable setting, -1 when none held up
+         */
+        [[nodiscard]] int best() const;
+
+        /**
+         * Result measured at the boot default
+         */
+        [[nodiscard]] const Result &baseline() const {
+            return defaultResult;
+        }
+
+    private:
+        StatusReader readStatus = nullptr;
+        TimeReader readTime = nullptr;
+        int expectedStatus = 0;
+        unsigned header[8]{};
+        Result defaultResult{};
+        Result results[SETTING_COUNT]{};
+        int next = 0;
+
+        Result measure(unsigned short waitcnt);
+    };
+}
@@ -42,27 +42,48 @@ EWRAM_CODE bool probeRom(unsigned short expected, unsigned short page) {
     return true;
 }
 
-EWRAM_CODE bool detect() {
+// Pages scanned per detectStep() call, keeps each interrupt-free window short
+#define PAGES_PER_STEP 32
+
+static int nextPage = 0;
+static unsigned short checksumCompliment = 0;
+
+EWRAM_CODE EzFlashScan detect() {
     unsigned short savedImeValue = REG_IME;
     REG_IME = 0;
-    const unsigned short checksumCompliment = ROM_HEADER_CHECKSUM;
+    checksumCompliment = ROM_HEADER_CHECKSUM;
+    nextPage = 0;
 
+    EzFlashScan result = EzFlashScan::Pending;
     if (probeRom(checksumCompliment, BOOTLOADER_PAGE_SECTION)) {
-        REG_IME = savedImeValue;
-        return false;
+        result = EzFlashScan::Absent;
+    } else if (probeRom(checksumCompliment, PSRAM_PAGE_SECTION)) {
+        result = EzFlashScan::Found;
+    } else if (probeRom(checksumCompliment, 0)) {
+        // Most images sit at the start of NOR
+        result = EzFlashScan::Found;
+        nextPage = 1;
+    } else {
+        nextPage = 1;
     }
 
-    if (probeRom(checksumCompliment, PSRAM_PAGE_SECTION)) {
-        REG_IME = savedImeValue;
-        return true;
-    }
+    REG_IME = savedImeValue;
+    return result;
+}
+
+EWRAM_CODE EzFlashScan detectStep() {
+    unsigned short savedImeValue = REG_IME;
+    REG_IME = 0;
 
-    for (int i = 0; i < S98WS512PE0_FLASH_PAGE_MAX; i++) {
-        if (!probeRom(checksumCompliment, i)) continue;
+    int lastPage = nextPage + PAGES_PER_STEP;
+    if (lastPage > S98WS512PE0_FLASH_PAGE_MAX) lastPage = S98WS512PE0_FLASH_PAGE_MAX;
+    for (; nextPage < lastPage; nextPage++) {
+        if (!probeRom(checksumCompliment, nextPage)) continue;
         REG_IME = savedImeValue;
-        return true;
+        return EzFlashScan::Found;
     }
 
     REG_IME = savedImeValue;
-    return false; // Hardware has failed out of spec
+    if (nextPage < S98WS512PE0_FLASH_PAGE_MAX) return EzFlashScan::Pending;
+    return EzFlashScan::Absent; // Hardware has failed out of spec
 }
@@ -1,5 +1,13 @@
 #pragma once
 
-bool detect();
+enum class EzFlashScan {
+    Pending, Found, Absent
+};
+
+// Probes the known page layouts, anything left over is scanned by detectStep()
+EzFlashScan detect();
+
+// Scans the next batch of kernel pages, call once per frame while Pending
+EzFlashScan detectStep();
 
 void EnableOdeRtc();
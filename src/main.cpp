@@ -4,14 +4,21 @@
  */
 
 #include "bn_core.h"
+#include "bn_log.h"
+#include "bn_timer.h"
+#include "bn_timers.h"
 #include "bn_bg_palettes.h"
 #include "bn_sprite_text_generator.h"
+#ifndef LUCKY_NO_MUSIC
+#include "bn_music.h"
 #include "bn_music_items.h"
+#endif
 
 #include "common_variable_8x16_sprite_font.h"
 
 #include "RtcSceneManager.h"
 #include "ezflash.h"
+#include "CartBoot.h"
 
 // Inform emulators and cart readers that this game supports RTC (flash saves often tied to this)
 alignas(int) __attribute__((used)) const char rtc_hint[] = "SIIRTC_V001\0";
@@ -26,12 +33,18 @@ static char *init() {
 RtcSceneManager::RtcSceneManager(bn::sprite_text_generator generator, bn::optional<bn::sprite_ptr> status)
         : textGenerator(
         generator), statusSprite(std::move(status)) {
-    sm.Initialize<ClientStates::WelcomeScene>(this);
+    sm.Initialize<ClientStates::CartMonitorState>(this);
 }
 
 int main() {
     // Hello Butano
     bn::core::init();
+    MEMORY_INIT();
+    WaitTuner::captureDefaults();
+    TestReport::init();
+    bn::timer bootTimer;
+    PROFILE_INIT();
+    BUS_TRACE_INIT();
 
     // Set backdrop
     bn::bg_palettes::set_transparent_color(bn::color(16, 20, 16));
@@ -44,22 +57,41 @@ int main() {
     // Set up scene manager
     RtcSceneManager sceneManager(textGenerator, statusSprite);
 
-    // Detect EZ Flash now
-    if (detect()) EnableOdeRtc();
+    // Detect EZ Flash from its known page layouts now, the exhaustive scan waits until we're on screen
+    EzFlashScan ezFlash = detect();
+    if (ezFlash == EzFlashScan::Found) EnableOdeRtc();
+    sceneManager.holdCartMonitor(ezFlash == EzFlashScan::Pending);
 
     bool musicStarted = false;
-    // Main logic loop, attempts to exit to inserted cart on common soft reset key combination
-    while (!(bn::keypad::start_held() && bn::keypad::select_held() && bn::keypad::a_held() && bn::keypad::b_held())) {
+    // Main logic loop, boots the inserted cart on common soft reset key combination
+    while (!(bn::keypad::start_held() && bn::keypad::select_held() && bn::keypad::a_held() && bn::keypad::b_held() &&
+             CartBoot::bootable())) {
         // Pump state machine and scene updates
         sceneManager.Update();
 
         // Call framework update after we're done
         bn::core::update();
+        PROFILE_FRAME();
+
+        // Spread what's left of the EZ Flash scan over the first frames
+        if (ezFlash == EzFlashScan::Pending) {
+            ezFlash = detectStep();
+            if (ezFlash == EzFlashScan::Found) EnableOdeRtc();
+            if (ezFlash != EzFlashScan::Pending) sceneManager.holdCartMonitor(false);
+        }
 
         // Start music, but only once after first render
         if (musicStarted) continue;
+        BN_LOG("Boot to first frame: ", bootTimer.elapsed_ticks() * 1000 / bn::timers::ticks_per_second(), " ms");
+#ifndef LUCKY_NO_MUSIC
         bn::music_items::trams.play(1.0, true);
+#endif
         musicStarted = true;
     }
-    return 0;
+
+#ifndef LUCKY_NO_MUSIC
+    if (bn::music::playing()) bn::music::stop();
+#endif
+    bn::core::update();
+    CartBoot::handOff();
 }
@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+"""
+Compares two CSVs written by `make bench`, e.g. from before and after a change:
+    tools/bench/compare.py before.csv build_bench/bench.csv
+
+Transitions are matched on source and target and averaged when the walk passes one more than once, text rows are
+matched on scene. Rows only one side has are listed with a blank for the other.
+"""
+
+import argparse
+import csv
+from collections import defaultdict
+
+
+def load(path):
+    samples = defaultdict(list)
+    with open(path, newline="") as file:
+        for row in csv.reader(file):
+            if not row:
+                continue
+            if row[0] == "transition":
+                samples[("transition", f"{row[1]} -> {row[2]}", "frames")].append(float(row[3]))
+            elif row[0] == "text":
+                samples[("text", row[1], "frames to draw")].append(float(row[3]))
+                samples[("text", row[1], "worst frame")].append(float(row[4]))
+            elif row[0] == "scene":
+                samples[("scene", row[1], "avg cpu %")].append(float(row[3]))
+                samples[("scene", row[1], "max cpu %")].append(float(row[4]))
+            elif row[0] == "rtc_bus":
+                samples[("rtc_bus", row[1], "cycles")].append(float(row[2]))
+    return {key: sum(values) / len(values) for key, values in samples.items()}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("before")
+    parser.add_argument("after")
+    args = parser.parse_args()
+
+    before = load(args.before)
+    after = load(args.after)
+    print(f"{'row':<10} {'name':<34} {'metric':<15} {'before':>10} {'after':>10} {'change':>8}")
+    for key in sorted(before.keys() | after.keys()):
+        old = before.get(key)
+        new = after.get(key)
+        change = f"{(new - old) / old * 100:+.0f}%" if old and new is not None else ""
+        print(f"{key[0]:<10} {key[1]:<34} {key[2]:<15} {'' if old is None else f'{old:.2f}':>10} "
+              f"{'' if new is None else f'{new:.2f}':>10} {change:>8}")
+
+
+if __name__ == "__main__":
+    main()
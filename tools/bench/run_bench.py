@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""
+Runs a bench ROM under a headless mGBA with the scripted walk and turns its BENCH/PROF log lines into a CSV.
+
+Rows are one of:
+    scene,<name>,<frames>,<avg cpu %>,<max cpu %>
+    transition,<from>,<to>,<frames>
+    text,<scene>,<lines>,<frames to draw>,<worst frame>
+    rtc_bus,total,<cycles>
+"""
+
+import argparse
+import csv
+import os
+import re
+import select
+import subprocess
+import sys
+import time
+
+# The walk is over once the chip reset lands us back on the status screen
+FINAL_TRANSITION = ("ResetScene", "StatusScene")
+# Scopes that together cover every bit-banged RTC transaction
+RTC_SCOPES = ("readStatus", "writeStatus", "setRTC", "resetChip")
+
+PROF_LINE = re.compile(r"PROF (?P<scope>.+?) n=\d+ min=\d+ avg=\d+ max=\d+ sum=(?P<sum>\d+)")
+
+
+def read_lines(stream, deadline):
+    """Yields lines from a pipe until EOF or the deadline, even while the emulator is silent."""
+    pending = b""
+    while True:
+        remaining = deadline - time.monotonic()
+        if remaining <= 0:
+            return
+        ready, _, _ = select.select([stream], [], [], remaining)
+        if not ready:
+            return
+        chunk = os.read(stream.fileno(), 4096)
+        if not chunk:
+            return
+        *lines, pending = (pending + chunk).split(b"\n")
+        for line in lines:
+            yield line.decode(errors="replace")
+
+
+def run(args):
+    env = dict(os.environ)
+    # Headless: no window, no audio device
+    env.setdefault("QT_QPA_PLATFORM", "offscreen")
+    env.setdefault("SDL_AUDIODRIVER", "dummy")
+    env.setdefault("SDL_VIDEODRIVER", "dummy")
+    command = [args.mgba, "-l", "255", "--script", args.script, args.rom]
+    process = subprocess.Popen(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, env=env)
+
+    rows = []
+    bus_cycles = 0
+    finished = False
+    deadline = time.monotonic() + args.timeout
+    try:
+        # Bench ROMs flush the profiler right before every transition line, so by the final transition the PROF
+        # lines for the whole walk have already arrived
+        for line in read_lines(process.stdout, deadline):
+            prof = PROF_LINE.search(line)
+            if prof and prof.group("scope") in RTC_SCOPES:
+                bus_cycles += int(prof.group("sum"))
+                continue
+            index = line.find("BENCH,")
+            if index < 0:
+                continue
+            fields = line[index:].strip().split(",")[1:]
+            if fields[0] == "scene":
+                name, frames, cpu_avg, cpu_max = fields[1:5]
+                rows.append(["scene", name, frames, int(cpu_avg) / 100, int(cpu_max) / 100])
+            elif fields[0] == "text":
+                name, lines, frames, hundredths = fields[1:5]
+                rows.append(["text", name, lines, frames, int(hundredths) / 100])
+            elif fields[0] == "transition":
+                source, target, hundredths = fields[1:4]
+                rows.append(["transition", source, target, int(hundredths) / 100])
+                if (source, target) == FINAL_TRANSITION:
+                    finished = True
+                    break
+    finally:
+        process.terminate()
+        process.wait()
+
+    rows.append(["rtc_bus", "total", bus_cycles])
+    os.makedirs(os.path.dirname(args.out) or ".", exist_ok=True)
+    with open(args.out, "w", newline="") as out:
+        csv.writer(out).writerows(rows)
+
+    if not finished:
+        reason = "timed out" if time.monotonic() >= deadline else "emulator exited"
+        print(f"bench: walk did not complete ({reason}), CSV is partial", file=sys.stderr)
+        return 1
+    print("bench: wrote {} rows to {}".format(len(rows), args.out))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--mgba", default="mgba-qt")
+    parser.add_argument("--rom", required=True)
+    parser.add_argument("--script", required=True)
+    parser.add_argument("--out", required=True)
+    parser.add_argument("--timeout", type=float, default=120)
+    return run(parser.parse_args())
+
+
+if __name__ == "__main__":
+    sys.exit(main())
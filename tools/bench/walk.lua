@@ -0,0 +1,44 @@
+-- Scripted walk for `make bench`, drives the ROM through every scene under mGBA.
+-- Welcome -> Status -> WallClock -> Edit -> save -> WallClock -> Reset -> Status
+
+local K = C.GBA_KEY
+
+-- Each step waits `wait` frames after the previous one, then holds `key` for a couple of frames
+local steps = {
+    { wait = 120, key = K.START },  -- Welcome -> Status
+    { wait = 90, key = K.START },   -- Status -> WallClock
+    { wait = 120, key = K.START },  -- WallClock -> Edit
+    { wait = 60, key = K.RIGHT },   -- select month
+    { wait = 20, key = K.UP },      -- bump it
+    { wait = 60, key = K.START },   -- save -> WallClock
+    { wait = 120, key = K.SELECT }, -- WallClock -> Reset
+    { wait = 60, key = K.SELECT },  -- send reset, wait for the chip to come back
+    { wait = 60, key = K.A },       -- Reset -> Status
+}
+
+local HOLD_FRAMES = 2
+
+local current = 1
+local nextFrame = nil
+local releaseFrame = nil
+
+callbacks:add("frame", function()
+    local frame = emu:currentFrame()
+    if releaseFrame and frame >= releaseFrame then
+        emu:clearKey(steps[current].key)
+        releaseFrame = nil
+        current = current + 1
+        nextFrame = nil
+    end
+    local step = steps[current]
+    if not step or releaseFrame then
+        return
+    end
+    if not nextFrame then
+        nextFrame = frame + step.wait
+    end
+    if frame >= nextFrame then
+        emu:addKey(step.key)
+        releaseFrame = frame + HOLD_FRAMES
+    end
+end)
@@ -0,0 +1,89 @@
+// Native microbenchmarks for the hardware-free formatting and calendar code.
+// Built and run with `make -C tools/host bench`, see tools/host/shim for the butano stand-ins.
+
+#include <chrono>
+#include <cstdio>
+
+#include "RtcFormat.h"
+#include "TimeFormatter.h"
+
+// Everything measured feeds this so the optimiser can't drop the work
+static volatile unsigned sink;
+
+template<typename Body>
+static void bench(const char *name, int calls, Body body) {
+    auto start = std::chrono::steady_clock::now();
+    unsigned accumulated = body();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    sink = accumulated;
+    double nanoseconds = std::chrono::duration<double, std::nano>(elapsed).count();
+    std::printf("%-24s %10d calls %10.1f ns/call\n", name, calls, nanoseconds / calls);
+}
+
+int main() {
+    constexpr int ROUNDS = 200;
+
+    bench("toBcd", ROUNDS * 100, [] {
+        unsigned total = 0;
+        for (int round = 0; round < ROUNDS; round++) {
+            for (unsigned value = 0; value < 100; value++) total += RtcFormat::toBcd(value);
+        }
+        return total;
+    });
+
+    // Every day the chip can represent, 2000-2099
+    bench("calculateDayOfWeekIndex", ROUNDS * 100 * 12 * 31, [] {
+        unsigned total = 0;
+        for (int round = 0; round < ROUNDS; round++) {
+            for (int year = 2000; year < 2100; year++) {
+                for (int month = 1; month <= 12; month++) {
+                    for (int day = 1; day <= 31; day++) total += RtcFormat::calculateDayOfWeekIndex(year, month, day);
+                }
+            }
+        }
+        return total;
+    });
+
+    // Every second of the day in both clock modes
+    bench("appendTime", 2 * 24 * 60 * 60, [] {
+        unsigned total = 0;
+        for (int mode = 0; mode < 2; mode++) {
+            for (int second = 0; second < 24 * 60 * 60; second++) {
+                bn::string<64> text;
+                RtcFormat::appendTime(text, second / 3600, second / 60 % 60, second % 60, mode);
+                total += text.size();
+            }
+        }
+        return total;
+    });
+
+    bench("appendDate", 100 * 12 * 28, [] {
+        unsigned total = 0;
+        for (int year = 2000; year < 2100; year++) {
+            for (int month = 1; month <= 12; month++) {
+                for (int day = 1; day <= 28; day++) {
+                    bn::string<64> text;
+                    RtcFormat::appendDate(text, year, month, day, RtcFormat::calculateDayOfWeekIndex(year, month, day));
+                    total += text.size();
+                }
+            }
+        }
+        return total;
+    });
+
+    // Every selectable component in both clock modes
+    bench("TimeFormatter::renderLine", ROUNDS * 2 * 7, [] {
+        unsigned total = 0;
+        for (int round = 0; round < ROUNDS; round++) {
+            for (int status = 0; status <= 0x40; status += 0x40) {
+                for (int selected = TimeFormatter::Year; selected <= TimeFormatter::Afternoon; selected++) {
+                    TimeFormatter formatter(24, 10, 9, 18, 27, round % 60, true, selected, status);
+                    total += formatter.renderLine().size();
+                }
+            }
+        }
+        return total;
+    });
+
+    return 0;
+}
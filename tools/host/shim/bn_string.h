@@ -0,0 +1,114 @@
+#pragma once
+
+// Host stand-in for butano's fixed capacity string, only what the pure formatting code touches.
+// Overflowing the capacity aborts, same as a failed BN_ASSERT on hardware.
+
+#include <cstdlib>
+#include <string>
+
+#include "bn_string_view.h"
+
+namespace bn {
+    template<int MaxSize>
+    class string {
+    public:
+        string() = default;
+
+        string(const char *text) {
+            append(text);
+        }
+
+        string(string_view text) {
+            append(text);
+        }
+
+        string(int count, char character) {
+            for (int i = 0; i < count; i++) push_back(character);
+        }
+
+        template<int OtherMaxSize>
+        string(const string<OtherMaxSize> &other) {
+            append(string_view(other));
+        }
+
+        operator string_view() const {
+            return value;
+        }
+
+        [[nodiscard]] int size() const {
+            return static_cast<int>(value.size());
+        }
+
+        [[nodiscard]] int length() const {
+            return size();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return value.empty();
+        }
+
+        [[nodiscard]] const char *data() const {
+            return value.data();
+        }
+
+        void clear() {
+            value.clear();
+        }
+
+        void push_back(char character) {
+            if (size() >= MaxSize) std::abort();
+            value.push_back(character);
+        }
+
+        string &operator+=(char character) {
+            push_back(character);
+            return *this;
+        }
+
+        string &operator+=(string_view text) {
+            append(text);
+            return *this;
+        }
+
+        string &operator+=(const char *text) {
+            append(text);
+            return *this;
+        }
+
+        template<int OtherMaxSize>
+        string &operator+=(const string<OtherMaxSize> &other) {
+            append(string_view(other));
+            return *this;
+        }
+
+        friend bool operator==(const string &a, string_view b) {
+            return string_view(a) == b;
+        }
+
+    private:
+        std::string value;
+
+        void append(string_view text) {
+            for (char character: text) push_back(character);
+        }
+    };
+
+    template<int MaxSize>
+    string<MaxSize> operator+(const char *a, const string<MaxSize> &b) {
+        string<MaxSize> result(a);
+        result += b;
+        return result;
+    }
+
+    template<int MaxSize, int OtherMaxSize>
+    string<MaxSize> operator+(const string<MaxSize> &a, const string<OtherMaxSize> &b) {
+        string<MaxSize> result(a);
+        result += b;
+        return result;
+    }
+
+    template<int MaxSize>
+    string<MaxSize> to_string(int value) {
+        return string<MaxSize>(string_view(std::to_string(value)));
+    }
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+// Host stand-in for butano's string_view, only what the pure formatting code touches
+#include <string_view>
+
+namespace bn {
+    using string_view = std::string_view;
+}
@@ -0,0 +1,113 @@
+// Native unit tests for the hardware-free formatting and calendar code.
+// Built and run with `make -C tools/host test`, see tools/host/shim for the butano stand-ins.
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "RtcFormat.h"
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(condition, ...)                                                   \
+    do {                                                                        \
+        checks++;                                                               \
+        if (!(condition)) {                                                     \
+            failures++;                                                         \
+            std::printf("%s:%d: %s failed: ", __FILE__, __LINE__, #condition);  \
+            std::printf(__VA_ARGS__);                                           \
+            std::printf("\n");                                                  \
+        }                                                                       \
+    } while (0)
+
+template<int MaxSize>
+static std::string_view view(const bn::string<MaxSize> &text) {
+    return {text.data(), static_cast<std::size_t>(text.size())};
+}
+
+/**
+ * Days since 1970-01-01 in the proleptic Gregorian calendar, written independently of Zeller's congruence
+ */
+static long daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long yearOfEra = year - era * 400;
+    long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+static void testBcd() {
+    for (unsigned value = 0; value < 100; value++) {
+        int bcd = RtcFormat::toBcd(value);
+        CHECK(bcd == static_cast<int>((value / 10) << 4 | value % 10), "toBcd(%u) = 0x%02X", value, bcd);
+        CHECK(RtcFormat::fromBcd(bcd) == static_cast<int>(value), "fromBcd(0x%02X) = %d", bcd, RtcFormat::fromBcd(bcd));
+    }
+}
+
+static void testDayOfWeek() {
+    // 1970-01-01 was a Thursday, Sunday is 0
+    for (int year = 2000; year < 2100; year++) {
+        for (int month = 1; month <= 12; month++) {
+            int days = RtcFormat::daysInMonth(year % 100, month);
+            for (int day = 1; day <= days; day++) {
+                int expected = static_cast<int>((daysFromCivil(year, month, day) % 7 + 11) % 7);
+                int actual = RtcFormat::calculateDayOfWeekIndex(year, month, day);
+                CHECK(actual == expected, "%04d-%02d-%02d gave %d, expected %d", year, month, day, actual, expected);
+            }
+        }
+    }
+    // The chip's two digit years agree with the full calendar on leap days
+    CHECK(RtcFormat::daysInMonth(0, 2) == 29, "2000 is a leap year");
+    CHECK(RtcFormat::daysInMonth(99, 2) == 28, "2099 is not");
+}
+
+static void checkTime(int hour, int minute, int second, bool twelveHour, const char *expected) {
+    bn::string<64> text;
+    RtcFormat::appendTime(text, hour, minute, second, twelveHour);
+    CHECK(view(text) == expected, "appendTime(%d, %d, %d, %d) gave \"%s\"", hour, minute, second, twelveHour,
+          std::string(view(text)).c_str());
+}
+
+static void testTime() {
+    checkTime(0, 0, 0, false, " 00:00:00");
+    checkTime(9, 5, 7, false, " 09:05:07");
+    checkTime(23, 59, 59, false, " 23:59:59");
+    // Midnight and noon both read 12 in 12 hour mode
+    checkTime(0, 0, 0, true, " 12:00:00 AM");
+    checkTime(12, 0, 0, true, " 12:00:00 PM");
+    checkTime(1, 2, 3, true, " 01:02:03 AM");
+    checkTime(11, 59, 59, true, " 11:59:59 AM");
+    checkTime(13, 0, 0, true, " 01:00:00 PM");
+    checkTime(23, 59, 59, true, " 11:59:59 PM");
+
+    // Appends rather than replaces
+    bn::string<64> text = "Now:";
+    RtcFormat::appendTime(text, 7, 8, 9, false);
+    CHECK(view(text) == "Now: 07:08:09", "appendTime kept the prefix");
+}
+
+static void testDate() {
+    bn::string<64> text;
+    RtcFormat::appendDate(text, 2000, 1, 1, 6);
+    CHECK(view(text) == "Saturday(6) 2000/1/1", "gave \"%s\"", std::string(view(text)).c_str());
+
+    text.clear();
+    RtcFormat::appendDate(text, 2024, 2, 29, 4);
+    CHECK(view(text) == "Thursday(4) 2024/2/29", "gave \"%s\"", std::string(view(text)).c_str());
+
+    // The name comes from the calendar, the number from the chip, so a wrong week day shows as a mismatch
+    text.clear();
+    RtcFormat::appendDate(text, 2099, 12, 31, 0);
+    CHECK(view(text) == "Thursday(0) 2099/12/31", "gave \"%s\"", std::string(view(text)).c_str());
+}
+
+int main() {
+    testBcd();
+    testDayOfWeek();
+    testTime();
+    testDate();
+    std::printf("%d checks, %d failed\n", checks, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""
+Reports multiboot image sizes against a budget and what they cost to send over the link cable.
+
+    tools/size/mb_report.py --budget 196608 full=lucky-rtc_mb.gba nomusic=lucky-rtc_mb_nomusic.gba
+
+Transfer times are line-rate floors for the two link modes the BIOS accepts an image over; real transfers add the
+sender's per-transfer gaps on top. Pass measured times (--measured "full=9.1 nomusic=4.2") to see the effective rate.
+If the matching .elf and a devkitARM nm are around, the largest symbols are listed too.
+Exits non-zero when any image is over budget.
+"""
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+
+# The BIOS refuses anything larger
+MULTIBOOT_LIMIT = 256 * 1024
+# Normal mode, 32-bit transfers at 256 KHz
+NORMAL_BYTES_PER_SECOND = 256 * 1024 / 8
+# Multiplay, 16-bit transfers at 115200 bps framed with a start and stop bit
+MULTIPLAY_BYTES_PER_SECOND = 115200 / 18 * 2
+TOP_SYMBOLS = 8
+
+
+def find_nm():
+    devkitarm = os.environ.get("DEVKITARM")
+    if devkitarm:
+        candidate = os.path.join(devkitarm, "bin", "arm-none-eabi-nm")
+        if os.path.exists(candidate):
+            return candidate
+    return shutil.which("arm-none-eabi-nm")
+
+
+def largest_symbols(nm, elf):
+    output = subprocess.run([nm, "--size-sort", "--reverse-sort", "--demangle", "-S", elf], capture_output=True,
+                            text=True, check=False).stdout
+    symbols = []
+    for line in output.splitlines():
+        parts = line.split(maxsplit=3)
+        # Only symbols that end up in the image: text and read only data
+        if len(parts) == 4 and parts[2] in "tTrR":
+            symbols.append((int(parts[1], 16), parts[3]))
+        if len(symbols) == TOP_SYMBOLS:
+            break
+    return symbols
+
+
+def parse_pairs(text):
+    pairs = {}
+    for item in text.split():
+        name, _, value = item.partition("=")
+        pairs[name] = value
+    return pairs
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--budget", type=int, default=MULTIBOOT_LIMIT, help="largest acceptable image in bytes")
+    parser.add_argument("--measured", default="", help="measured transfer seconds per variant, name=seconds")
+    parser.add_argument("images", nargs="+", help="variant=path.gba")
+    args = parser.parse_args()
+
+    measured = {name: float(seconds) for name, seconds in parse_pairs(args.measured).items()}
+    nm = find_nm()
+    over = False
+    for name, path in parse_pairs(" ".join(args.images)).items():
+        size = os.path.getsize(path)
+        over |= size > args.budget or size > MULTIBOOT_LIMIT
+        print(f"{name}: {path}")
+        print(f"  size      {size:8d} bytes, {size * 100 / args.budget:5.1f}% of budget {args.budget}, "
+              f"{args.budget - size:+d} left")
+        print(f"  floor     {size / NORMAL_BYTES_PER_SECOND:5.2f} s normal mode, "
+              f"{size / MULTIPLAY_BYTES_PER_SECOND:5.2f} s multiplay")
+        if name in measured:
+            print(f"  measured  {measured[name]:5.2f} s, {size / measured[name] / 1024:.1f} KiB/s effective")
+
+        elf = os.path.splitext(path)[0] + ".elf"
+        if nm and os.path.exists(elf):
+            for symbol_size, symbol in largest_symbols(nm, elf):
+                print(f"  {symbol_size:8d}  {symbol}")
+
+    if over:
+        print("Over budget", file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
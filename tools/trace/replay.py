@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+"""
+Replays a GPIO bus trace sent by a TRACE=1 build (hold L+R for two seconds) and decodes it into RTC transactions.
+
+The trace arrives as LRTCTRC1 lines in the mGBA log or on the link port UART. Save either capture to a file, e.g.:
+    tools/trace/replay.py mgba.log
+    tools/trace/replay.py serial.txt --raw
+Anything else in the capture is skipped, and when it holds several dumps the last complete one is used.
+
+Pins are bit 0 SCK, bit 1 SIO, bit 2 CS. A bit is latched on every rising SCK edge while CS is high, taken from the
+written SIO level when SIO is an output and from the following read of the data register otherwise.
+Command bytes go out MSB first, data bytes LSB first, as on the S-3511A.
+"""
+
+import argparse
+import sys
+
+MAGIC = "LRTCTRC1"
+
+SCK = 0b001
+SIO = 0b010
+CS = 0b100
+
+REGISTERS = ("DAT", "DIR", "CTL")
+COMMANDS = {0: "reset", 1: "status", 2: "datetime", 3: "time", 4: "alarm1", 5: "alarm2", 6: "irq", 7: "free"}
+# Payload length of every command, for flagging short transactions
+PAYLOAD_BYTES = {0: 0, 1: 1, 2: 7, 3: 3, 4: 2, 5: 2, 6: 0, 7: 1}
+
+
+def load(path):
+    dump = None
+    complete = None
+    with open(path, errors="replace") as file:
+        for line in file:
+            position = line.find(MAGIC)
+            if position < 0:
+                continue
+            words = line[position + len(MAGIC):].split()
+            if not words:
+                continue
+            if words[0] == "begin":
+                fields = dict(word.split("=", 1) for word in words[1:] if "=" in word)
+                dump = (int(fields["events"]), int(fields["cps"]), [])
+            elif words[0] == "data" and dump is not None:
+                dump[2].extend(int(word, 16) for word in words[1:])
+            elif words[0] == "end" and dump is not None:
+                complete = dump
+                dump = None
+    if complete is None:
+        sys.exit(f"{path}: no complete bus trace found")
+    count, cycles_per_second, data = complete
+    if len(data) != count:
+        sys.exit(f"{path}: trace announced {count} events but carried {len(data)}")
+    events = []
+    cycles = 0
+    for word in data:
+        cycles += word >> 8
+        events.append((cycles, bool(word & 0x40), REGISTERS[(word >> 4) & 0x3], word & 0xF))
+    return events, cycles_per_second
+
+
+class Transaction:
+    def __init__(self, start):
+        self.start = start
+        self.end = start
+        self.bits = []
+
+    def decode(self):
+        if len(self.bits) < 8:
+            return None, False, []
+        command = 0
+        for bit in self.bits[:8]:
+            command = command << 1 | bit
+        payload = []
+        for offset in range(8, len(self.bits) - 7, 8):
+            byte = 0
+            for index, bit in enumerate(self.bits[offset:offset + 8]):
+                byte |= bit << index
+            payload.append(byte)
+        return command, bool(command & 1), payload
+
+
+def replay(events):
+    """Tracks the pin state through every access and yields one Transaction per CS high period."""
+    dat = 0
+    direction = 0
+    current = None
+    awaiting_read = False
+    for cycles, read, register, value in events:
+        if register == "DIR":
+            direction = value
+            continue
+        if register == "CTL":
+            continue
+        if read:
+            if awaiting_read and current is not None:
+                current.bits.append(1 if value & SIO else 0)
+                awaiting_read = False
+            continue
+
+        previous = dat
+        dat = value
+        if value & CS and not previous & CS:
+            current = Transaction(cycles)
+        elif previous & CS and not value & CS and current is not None:
+            current.end = cycles
+            yield current
+            current = None
+        if current is None or not value & CS:
+            continue
+        current.end = cycles
+        if value & SCK and not previous & SCK:
+            if direction & SIO:
+                current.bits.append(1 if value & SIO else 0)
+            else:
+                awaiting_read = True
+    if current is not None:
+        yield current
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", help="mGBA log or serial capture containing the trace")
+    parser.add_argument("--raw", action="store_true", help="also print every register access")
+    args = parser.parse_args()
+
+    events, cycles_per_second = load(args.capture)
+    to_us = 1_000_000 / cycles_per_second
+    print(f"{len(events)} accesses over {events[-1][0] * to_us:.0f} us" if events else "Empty trace")
+
+    if args.raw:
+        for cycles, read, register, value in events:
+            print(f"{cycles * to_us:12.2f} us  {'R' if read else 'W'} {register} {value:03b}")
+
+    for transaction in replay(events):
+        command, is_read, payload = transaction.decode()
+        duration = (transaction.end - transaction.start) * to_us
+        if command is None:
+            print(f"{transaction.start * to_us:12.2f} us  ({len(transaction.bits)} stray bits)")
+            continue
+        if command >> 4 != 0b0110:
+            print(f"{transaction.start * to_us:12.2f} us  bad command byte {command:08b}")
+            continue
+        code = (command >> 1) & 0x7
+        name = COMMANDS[code]
+        data = " ".join(f"{byte:02X}" for byte in payload)
+        note = "" if len(payload) >= PAYLOAD_BYTES[code] else "  (short)"
+        print(f"{transaction.start * to_us:12.2f} us  {'read ' if is_read else 'write'} {name:<8} [{data}] "
+              f"{duration:.1f} us{note}")
+
+
+if __name__ == "__main__":
+    main()